@@ -0,0 +1,20 @@
+# Makefile for graph algorithm benchmarks
+
+CC = gcc
+CFLAGS = -O2 -Wall -Wextra -pthread
+SRCDIR = ../src
+OUTDIR = ../out
+TARGET = $(OUTDIR)/bench_graphs
+
+all: $(OUTDIR) $(TARGET)
+
+$(OUTDIR):
+	mkdir -p $(OUTDIR)
+
+$(TARGET): $(SRCDIR)/bench_graphs.c $(SRCDIR)/9_graphs.c $(SRCDIR)/9_graphs.h
+	$(CC) $(CFLAGS) -DSKIP_MAIN $(SRCDIR)/bench_graphs.c $(SRCDIR)/9_graphs.c -o $@ -lm -pthread
+
+clean:
+	rm -f $(TARGET)
+
+.PHONY: all clean
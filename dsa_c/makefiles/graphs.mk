@@ -1,7 +1,7 @@
 # Makefile for graphs
 
 CC = gcc
-CFLAGS = -Wall -Wextra
+CFLAGS = -Wall -Wextra -pthread
 SRCDIR = ../src
 OUTDIR = ../out
 TARGET = $(OUTDIR)/9_graphs
@@ -11,8 +11,8 @@ all: $(OUTDIR) $(TARGET)
 $(OUTDIR):
 	mkdir -p $(OUTDIR)
 
-$(TARGET): $(SRCDIR)/9_graphs.c
-	$(CC) $(CFLAGS) $(SRCDIR)/9_graphs.c -o $@ -lm
+$(TARGET): $(SRCDIR)/9_graphs.c $(SRCDIR)/9_graphs.h
+	$(CC) $(CFLAGS) $(SRCDIR)/9_graphs.c -o $@ -lm -pthread
 
 clean:
 	rm -f $(TARGET)
@@ -1,7 +1,7 @@
 # Makefile for hash_tables
 
 CC = gcc
-CFLAGS = -Wall -Wextra
+CFLAGS = -O2 -Wall -Wextra -pthread
 SRCDIR = ../src
 OUTDIR = ../out
 TARGET = $(OUTDIR)/10_hash_tables
@@ -12,7 +12,7 @@ $(OUTDIR):
 	mkdir -p $(OUTDIR)
 
 $(TARGET): $(SRCDIR)/10_hash_tables.c
-	$(CC) $(CFLAGS) $(SRCDIR)/10_hash_tables.c -o $@
+	$(CC) $(CFLAGS) $(SRCDIR)/10_hash_tables.c -o $@ -lm
 
 clean:
 	rm -f $(TARGET)
@@ -17,60 +17,21 @@
 #include <stdbool.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 #include <math.h>
-
-// ============================================================
-// ENUMS AND CONSTANTS
-// ============================================================
-
-typedef enum {
-    DIRECTED,
-    UNDIRECTED
-} GraphType;
-
-typedef enum {
-    WEIGHTED,
-    UNWEIGHTED
-} WeightType;
-
-typedef enum {
-    ADJACENCY_MATRIX,
-    ADJACENCY_LIST
-} RepType;
-
-#define INF INT_MAX
-#define NO_EDGE 0
-
-// ============================================================
-// DATA STRUCTURES
-// ============================================================
-
-/**
- * Node in adjacency list
- */
-typedef struct AdjListNode {
-    int dest;                    // Destination vertex
-    int weight;                  // Edge weight (1 if unweighted)
-    struct AdjListNode* next;    // Next node in list
-} AdjListNode;
-
-/**
- * Graph structure supporting both representations
- */
-typedef struct {
-    GraphType type;              // DIRECTED or UNDIRECTED
-    WeightType weight_type;      // WEIGHTED or UNWEIGHTED
-    RepType representation;      // ADJACENCY_MATRIX or ADJACENCY_LIST
-
-    int num_vertices;            // Number of vertices
-    int num_edges;               // Number of edges
-
-    // Adjacency Matrix (if representation == ADJACENCY_MATRIX)
-    int** adj_matrix;            // 2D array: adj_matrix[i][j] = weight of edge i->j
-
-    // Adjacency List (if representation == ADJACENCY_LIST)
-    AdjListNode** adj_list;      // Array of linked lists
-} Graph;
+#include <float.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <signal.h>
+
+#include "9_graphs.h"
 
 // ============================================================
 // HELPER FUNCTIONS - ADJACENCY LIST
@@ -122,6 +83,245 @@ void free_adj_list(AdjListNode* head) {
     }
 }
 
+// ============================================================
+// HELPER FUNCTIONS - NODE ARENA (slab allocator)
+// ============================================================
+
+/**
+ * Node Arena - slab allocation for adjacency list nodes
+ *
+ * Problem with malloc per edge:
+ * - Every graph_add_edge() pays for a malloc call (+16 B header)
+ * - graph_destroy() walks every list and frees every node: O(E) frees
+ * - Nodes of one vertex end up scattered across the heap
+ *
+ * Arena approach:
+ * - Memory comes from a few large slabs (thousands of nodes each)
+ * - Each vertex gets its own CHUNK inside a slab; when the chunk is
+ *   used up the vertex gets a new chunk twice the size (4, 8, ... 256)
+ *   → a vertex's neighbors are contiguous in memory
+ * - Allocation is a pointer bump: no malloc on the hot path
+ * - Teardown frees the slabs only: O(number of slabs), not O(E)
+ * - node_arena_reset() keeps the slabs for the next graph
+ *
+ *   slab 0: [v3 v3 v3 v3][v7 v7 v7 v7][v3 v3 v3 v3 v3 v3 v3 v3][...]
+ *   slab 1: [...]
+ *
+ * Trade-off: no per-node free (graphs here never delete edges), and
+ * unused tails of chunks are wasted (bounded by chunk doubling).
+ */
+
+#define ARENA_MIN_CHUNK 4
+#define ARENA_MAX_CHUNK 256
+#define ARENA_MIN_SLAB_NODES 4096
+
+static NodeSlab* node_slab_create(size_t capacity) {
+    NodeSlab* slab = (NodeSlab*)malloc(sizeof(NodeSlab) + capacity * sizeof(AdjListNode));
+    slab->next = NULL;
+    slab->used = 0;
+    slab->capacity = capacity;
+    return slab;
+}
+
+/**
+ * Create an arena sized for roughly expected_nodes list nodes
+ */
+NodeArena* node_arena_create(int num_vertices, size_t expected_nodes) {
+    NodeArena* arena = (NodeArena*)malloc(sizeof(NodeArena));
+    arena->slab_nodes = expected_nodes > ARENA_MIN_SLAB_NODES ? expected_nodes : ARENA_MIN_SLAB_NODES;
+    arena->head = arena->current = node_slab_create(arena->slab_nodes);
+    arena->num_slabs = 1;
+    arena->chunk_next = (AdjListNode**)calloc(num_vertices, sizeof(AdjListNode*));
+    arena->chunk_left = (int*)calloc(num_vertices, sizeof(int));
+    arena->chunk_size = (int*)calloc(num_vertices, sizeof(int));
+    return arena;
+}
+
+/**
+ * Carve a chunk of n nodes from the current slab (moving to the next
+ * slab, or allocating one, when the current slab is full)
+ */
+static AdjListNode* node_arena_carve(NodeArena* arena, int n) {
+    while (arena->current->used + n > arena->current->capacity) {
+        if (arena->current->next == NULL) {
+            arena->current->next = node_slab_create(arena->slab_nodes);
+            arena->num_slabs++;
+        }
+        arena->current = arena->current->next;
+        arena->current->used = 0;
+    }
+
+    AdjListNode* chunk = arena->current->nodes + arena->current->used;
+    arena->current->used += n;
+    return chunk;
+}
+
+/**
+ * Allocate a list node for vertex u (pointer bump inside u's chunk)
+ */
+AdjListNode* node_arena_alloc(NodeArena* arena, int u, int dest, int weight) {
+    if (arena->chunk_left[u] == 0) {
+        int size = arena->chunk_size[u] == 0 ? ARENA_MIN_CHUNK : 2 * arena->chunk_size[u];
+        if (size > ARENA_MAX_CHUNK) size = ARENA_MAX_CHUNK;
+        arena->chunk_size[u] = size;
+        arena->chunk_left[u] = size;
+        arena->chunk_next[u] = node_arena_carve(arena, size);
+    }
+
+    AdjListNode* node = arena->chunk_next[u]++;
+    arena->chunk_left[u]--;
+    node->dest = dest;
+    node->weight = weight;
+    node->next = NULL;
+    return node;
+}
+
+/**
+ * Forget all nodes but keep the slabs for reuse
+ */
+void node_arena_reset(NodeArena* arena, int num_vertices) {
+    arena->current = arena->head;
+    arena->current->used = 0;
+    memset(arena->chunk_left, 0, num_vertices * sizeof(int));
+    memset(arena->chunk_size, 0, num_vertices * sizeof(int));
+}
+
+/**
+ * Free the arena: O(number of slabs)
+ */
+void node_arena_destroy(NodeArena* arena) {
+    NodeSlab* slab = arena->head;
+    while (slab != NULL) {
+        NodeSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(arena->chunk_next);
+    free(arena->chunk_left);
+    free(arena->chunk_size);
+    free(arena);
+}
+
+// ============================================================
+// HELPER FUNCTIONS - EDGE INDEX (open addressing)
+// ============================================================
+
+/**
+ * Edge Index - hash set of (src, dst) pairs with an int payload
+ *
+ * Problem:
+ * - has_edge_in_list() walks the whole neighbor list: O(degree)
+ * - graph_add_edge() checks for duplicates on EVERY insert, so building
+ *   a hub vertex with d neighbors costs O(d²)
+ *
+ * Solution: open addressing with linear probing
+ * - Key: (src << 32 | dst) + 1 packed into one uint64_t (0 = empty)
+ * - Hash: 64-bit mixer (splitmix64 finalizer), masked to capacity
+ * - Linear probing: collisions land in the next slot → probes stay in
+ *   the same cache line most of the time
+ * - Capacity doubles when load factor exceeds 0.7
+ * - No deletion needed: graphs here never remove edges
+ *
+ * Time: O(1) expected lookup/insert
+ * Space: 12 bytes per slot (~17 bytes per stored arc at load 0.7)
+ */
+
+static inline uint64_t edge_index_key(int src, int dst) {
+    return (((uint64_t)(uint32_t)src << 32) | (uint32_t)dst) + 1;
+}
+
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+EdgeIndex* edge_index_create(size_t expected) {
+    EdgeIndex* index = (EdgeIndex*)malloc(sizeof(EdgeIndex));
+    size_t capacity = 16;
+    while (capacity * 7 < expected * 10) {
+        capacity *= 2;
+    }
+    index->capacity = capacity;
+    index->count = 0;
+    index->keys = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+    index->values = (int*)malloc(capacity * sizeof(int));
+    return index;
+}
+
+void edge_index_destroy(EdgeIndex* index) {
+    free(index->keys);
+    free(index->values);
+    free(index);
+}
+
+void edge_index_clear(EdgeIndex* index) {
+    memset(index->keys, 0, index->capacity * sizeof(uint64_t));
+    index->count = 0;
+}
+
+/**
+ * Find slot holding key, or the empty slot where it would go
+ */
+static inline size_t edge_index_slot(const EdgeIndex* index, uint64_t key) {
+    size_t mask = index->capacity - 1;
+    size_t i = mix64(key) & mask;
+    while (index->keys[i] != 0 && index->keys[i] != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * Look up (src, dst)
+ *
+ * @return Pointer to the stored value, or NULL if absent
+ */
+int* edge_index_find(const EdgeIndex* index, int src, int dst) {
+    size_t i = edge_index_slot(index, edge_index_key(src, dst));
+    return index->keys[i] != 0 ? &index->values[i] : NULL;
+}
+
+static void edge_index_grow(EdgeIndex* index) {
+    uint64_t* old_keys = index->keys;
+    int* old_values = index->values;
+    size_t old_capacity = index->capacity;
+
+    index->capacity *= 2;
+    index->keys = (uint64_t*)calloc(index->capacity, sizeof(uint64_t));
+    index->values = (int*)malloc(index->capacity * sizeof(int));
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_keys[i] == 0) continue;
+        size_t j = edge_index_slot(index, old_keys[i]);
+        index->keys[j] = old_keys[i];
+        index->values[j] = old_values[i];
+    }
+
+    free(old_keys);
+    free(old_values);
+}
+
+/**
+ * Insert (src, dst) → value, or update the value if already present
+ */
+void edge_index_put(EdgeIndex* index, int src, int dst, int value) {
+    if ((index->count + 1) * 10 > index->capacity * 7) {
+        edge_index_grow(index);
+    }
+
+    uint64_t key = edge_index_key(src, dst);
+    size_t i = edge_index_slot(index, key);
+    if (index->keys[i] == 0) {
+        index->keys[i] = key;
+        index->count++;
+    }
+    index->values[i] = value;
+}
+
 // ============================================================
 // GRAPH CREATION AND MANAGEMENT
 // ============================================================
@@ -155,10 +355,75 @@ Graph* graph_create(int num_vertices, GraphType type, WeightType weight_type, Re
         graph->adj_list = (AdjListNode**)calloc(num_vertices, sizeof(AdjListNode*));
         graph->adj_matrix = NULL;
     }
+    graph->arena = NULL;
+    graph->edge_index = NULL;
+
+    return graph;
+}
+
+/**
+ * Attach a hashed (src, dst) index to an adjacency list graph
+ *
+ * After this, graph_has_edge(), get_edge_weight() and the duplicate
+ * check in graph_add_edge() are O(1) expected instead of O(degree).
+ * Existing edges are indexed; later edges are indexed as they are added.
+ * (Matrix graphs already have O(1) lookup - nothing to do.)
+ */
+void graph_enable_edge_index(Graph* graph) {
+    if (graph->representation != ADJACENCY_LIST || graph->edge_index != NULL) {
+        return;
+    }
+
+    size_t arcs = (size_t)graph->num_edges * (graph->type == UNDIRECTED ? 2 : 1);
+    graph->edge_index = edge_index_create(arcs);
+
+    for (int u = 0; u < graph->num_vertices; u++) {
+        for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+            edge_index_put(graph->edge_index, u, node->dest, node->weight);
+        }
+    }
+}
 
+/**
+ * Create an adjacency list graph whose nodes come from a slab arena
+ *
+ * Building is allocation-free on the hot path and graph_destroy()
+ * frees a handful of slabs instead of every node.
+ *
+ * @param expected_edges  Size hint for the slabs (0 if unknown)
+ */
+Graph* graph_create_arena(int num_vertices, GraphType type, WeightType weight_type,
+                          int expected_edges) {
+    Graph* graph = graph_create(num_vertices, type, weight_type, ADJACENCY_LIST);
+    size_t expected_nodes = (size_t)expected_edges * (type == UNDIRECTED ? 2 : 1);
+    graph->arena = node_arena_create(num_vertices, expected_nodes);
     return graph;
 }
 
+/**
+ * Remove all edges but keep the graph (and its arena slabs) for reuse
+ */
+void graph_clear(Graph* graph) {
+    if (graph->representation == ADJACENCY_MATRIX) {
+        for (int i = 0; i < graph->num_vertices; i++) {
+            memset(graph->adj_matrix[i], 0, graph->num_vertices * sizeof(int));
+        }
+    } else {
+        if (graph->arena != NULL) {
+            node_arena_reset(graph->arena, graph->num_vertices);
+        } else {
+            for (int i = 0; i < graph->num_vertices; i++) {
+                free_adj_list(graph->adj_list[i]);
+            }
+        }
+        memset(graph->adj_list, 0, graph->num_vertices * sizeof(AdjListNode*));
+        if (graph->edge_index != NULL) {
+            edge_index_clear(graph->edge_index);
+        }
+    }
+    graph->num_edges = 0;
+}
+
 /**
  * Destroy graph and free memory
  */
@@ -169,10 +434,18 @@ void graph_destroy(Graph* graph) {
         }
         free(graph->adj_matrix);
     } else {
-        for (int i = 0; i < graph->num_vertices; i++) {
-            free_adj_list(graph->adj_list[i]);
+        if (graph->arena != NULL) {
+            // Arena: free slabs, not individual nodes
+            node_arena_destroy(graph->arena);
+        } else {
+            for (int i = 0; i < graph->num_vertices; i++) {
+                free_adj_list(graph->adj_list[i]);
+            }
         }
         free(graph->adj_list);
+        if (graph->edge_index != NULL) {
+            edge_index_destroy(graph->edge_index);
+        }
     }
     free(graph);
 }
@@ -181,6 +454,33 @@ void graph_destroy(Graph* graph) {
 // EDGE OPERATIONS
 // ============================================================
 
+/**
+ * Prepend dest to src's adjacency list using the graph's allocator
+ */
+static void graph_list_insert(Graph* graph, int src, int dest, int weight) {
+    if (graph->arena != NULL) {
+        AdjListNode* node = node_arena_alloc(graph->arena, src, dest, weight);
+        node->next = graph->adj_list[src];
+        graph->adj_list[src] = node;
+    } else {
+        add_to_adj_list(&graph->adj_list[src], dest, weight);
+    }
+
+    if (graph->edge_index != NULL) {
+        edge_index_put(graph->edge_index, src, dest, weight);
+    }
+}
+
+/**
+ * Check src's list for dest - O(1) with an edge index, O(degree) without
+ */
+static bool graph_list_has_edge(Graph* graph, int src, int dest) {
+    if (graph->edge_index != NULL) {
+        return edge_index_find(graph->edge_index, src, dest) != NULL;
+    }
+    return has_edge_in_list(graph->adj_list[src], dest);
+}
+
 /**
  * Add edge to graph
  *
@@ -213,13 +513,13 @@ void graph_add_edge(Graph* graph, int src, int dest, int weight) {
         }
     } else {
         // Add to list
-        if (!has_edge_in_list(graph->adj_list[src], dest)) {
-            add_to_adj_list(&graph->adj_list[src], dest, weight);
+        if (!graph_list_has_edge(graph, src, dest)) {
+            graph_list_insert(graph, src, dest, weight);
             graph->num_edges++;
 
             // If undirected, add reverse edge
             if (graph->type == UNDIRECTED && src != dest) {
-                add_to_adj_list(&graph->adj_list[dest], src, weight);
+                graph_list_insert(graph, dest, src, weight);
             }
         }
     }
@@ -236,7 +536,7 @@ bool graph_has_edge(Graph* graph, int src, int dest) {
     if (graph->representation == ADJACENCY_MATRIX) {
         return graph->adj_matrix[src][dest] != NO_EDGE;
     } else {
-        return has_edge_in_list(graph->adj_list[src], dest);
+        return graph_list_has_edge(graph, src, dest);
     }
 }
 
@@ -390,6 +690,9 @@ void graph_display_list(Graph* graph) {
 int get_edge_weight(Graph* graph, int src, int dest) {
     if (graph->representation == ADJACENCY_MATRIX) {
         return graph->adj_matrix[src][dest];
+    } else if (graph->edge_index != NULL) {
+        int* weight = edge_index_find(graph->edge_index, src, dest);
+        return weight != NULL ? *weight : NO_EDGE;
     } else {
         AdjListNode* node = graph->adj_list[src];
         while (node != NULL) {
@@ -680,6 +983,7 @@ Graph* graph_create_complete(int num_vertices, GraphType type, WeightType weight
  */
 Graph* graph_create_sparse(int num_vertices, GraphType type, WeightType weight_type, int num_edges) {
     Graph* graph = graph_create(num_vertices, type, weight_type, ADJACENCY_LIST);
+    graph_enable_edge_index(graph);  // O(1) duplicate checks while generating
 
     printf("Building sparse graph with %d vertices and ~%d edges...\n", num_vertices, num_edges);
 
@@ -713,6 +1017,7 @@ Graph* graph_create_sparse(int num_vertices, GraphType type, WeightType weight_t
  */
 Graph* graph_create_dag(int num_vertices, int num_edges, WeightType weight_type) {
     Graph* graph = graph_create(num_vertices, DIRECTED, weight_type, ADJACENCY_LIST);
+    graph_enable_edge_index(graph);  // O(1) duplicate checks while generating
 
     printf("Building DAG with %d vertices and ~%d edges...\n", num_vertices, num_edges);
 
@@ -741,6 +1046,7 @@ Graph* graph_create_dag(int num_vertices, int num_edges, WeightType weight_type)
  */
 Graph* graph_create_bipartite(int num_vertices, GraphType type, WeightType weight_type, int num_edges) {
     Graph* graph = graph_create(num_vertices, type, weight_type, ADJACENCY_LIST);
+    graph_enable_edge_index(graph);  // O(1) duplicate checks while generating
 
     int split = num_vertices / 2;
     printf("Building bipartite graph: Set1=[0,%d) Set2=[%d,%d) with ~%d edges...\n",
@@ -904,6 +1210,83 @@ bool graph_is_dag(Graph* graph) {
 // SHORTEST PATH ALGORITHMS
 // ============================================================
 
+/**
+ * Walk parent[] back from dest and store the path source-first
+ *
+ * @return Number of vertices on the path
+ */
+static int path_from_parents(const int* parent, int dest, int* path) {
+    int path_len = 0;
+    for (int current = dest; current != -1; current = parent[current]) {
+        path_len++;
+    }
+    int i = path_len;
+    for (int current = dest; current != -1; current = parent[current]) {
+        path[--i] = current;
+    }
+    return path_len;
+}
+
+/**
+ * Print weighted shortest-path results from a parent array: one path
+ * with its edge weights, or a table to every vertex when dest is -1
+ */
+static void print_shortest_paths(Graph* graph, int src, int dest,
+                                 const int* distance, const int* parent) {
+    int* path = (int*)malloc(graph->num_vertices * sizeof(int));
+
+    if (dest >= 0) {
+        // Single destination
+        if (distance[dest] == INF) {
+            printf("No path found\n");
+        } else {
+            printf("Shortest path found!\n");
+            printf("Total weight: %d\n\n", distance[dest]);
+
+            // Print path with weights
+            int path_len = path_from_parents(parent, dest, path);
+            printf("Path: ");
+            int total_weight = 0;
+            for (int i = 0; i < path_len; i++) {
+                printf("%d", path[i]);
+                if (i < path_len - 1) {
+                    int weight = get_edge_weight(graph, path[i], path[i+1]);
+                    printf(" -(%d)-> ", weight);
+                    total_weight += weight;
+                }
+            }
+            printf("\n");
+            printf("Verification: Total weight = %d\n", total_weight);
+        }
+    } else {
+        // All destinations
+        printf("Shortest paths from vertex %d:\n\n", src);
+        printf("Dest | Distance | Path\n");
+        printf("-----|----------|---------------------\n");
+
+        for (int i = 0; i < graph->num_vertices; i++) {
+            if (i == src) continue;
+
+            printf(" %2d  | ", i);
+
+            if (distance[i] == INF) {
+                printf("   INF   | No path\n");
+            } else {
+                printf("%6d   | ", distance[i]);
+
+                int path_len = path_from_parents(parent, i, path);
+                for (int j = 0; j < path_len; j++) {
+                    printf("%d", path[j]);
+                    if (j < path_len - 1) printf("->");
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    free(path);
+}
+
 /**
  * BFS Shortest Path for Unweighted Graphs
  *
@@ -933,55 +1316,9 @@ void graph_bfs_shortest_path(Graph* graph, int src, int dest) {
         return;
     }
 
-    // Arrays for BFS
-    bool* visited = (bool*)calloc(graph->num_vertices, sizeof(bool));
     int* distance = (int*)malloc(graph->num_vertices * sizeof(int));
     int* parent = (int*)malloc(graph->num_vertices * sizeof(int));
-    int* queue = (int*)malloc(graph->num_vertices * sizeof(int));
-
-    // Initialize
-    for (int i = 0; i < graph->num_vertices; i++) {
-        distance[i] = INF;
-        parent[i] = -1;
-    }
-
-    // BFS initialization
-    distance[src] = 0;
-    visited[src] = true;
-    int front = 0, rear = 0;
-    queue[rear++] = src;
-
-    // BFS traversal
-    while (front < rear) {
-        int u = queue[front++];
-
-        // Early exit if we reached destination
-        if (u == dest) break;
-
-        // Explore neighbors
-        if (graph->representation == ADJACENCY_LIST) {
-            AdjListNode* node = graph->adj_list[u];
-            while (node != NULL) {
-                int v = node->dest;
-                if (!visited[v]) {
-                    visited[v] = true;
-                    distance[v] = distance[u] + 1;  // All edges weight 1
-                    parent[v] = u;
-                    queue[rear++] = v;
-                }
-                node = node->next;
-            }
-        } else {
-            for (int v = 0; v < graph->num_vertices; v++) {
-                if (graph->adj_matrix[u][v] != NO_EDGE && !visited[v]) {
-                    visited[v] = true;
-                    distance[v] = distance[u] + 1;
-                    parent[v] = u;
-                    queue[rear++] = v;
-                }
-            }
-        }
-    }
+    graph_bfs_quiet(graph, src, distance, parent);
 
     // Print result
     if (distance[dest] == INF) {
@@ -990,30 +1327,19 @@ void graph_bfs_shortest_path(Graph* graph, int src, int dest) {
         printf("Shortest path found!\n");
         printf("Distance: %d edges\n\n", distance[dest]);
 
-        // Reconstruct path
         int* path = (int*)malloc(graph->num_vertices * sizeof(int));
-        int path_len = 0;
-        int current = dest;
-        while (current != -1) {
-            path[path_len++] = current;
-            current = parent[current];
-        }
-
-        // Print path (reverse order)
+        int path_len = path_from_parents(parent, dest, path);
         printf("Path: ");
-        for (int i = path_len - 1; i >= 0; i--) {
+        for (int i = 0; i < path_len; i++) {
             printf("%d", path[i]);
-            if (i > 0) printf(" -> ");
+            if (i < path_len - 1) printf(" -> ");
         }
         printf("\n");
-
         free(path);
     }
 
-    free(visited);
     free(distance);
     free(parent);
-    free(queue);
 }
 
 /**
@@ -1063,142 +1389,14 @@ void graph_dijkstra(Graph* graph, int src, int dest) {
         return;
     }
 
-    // Arrays for Dijkstra
     int* distance = (int*)malloc(graph->num_vertices * sizeof(int));
     int* parent = (int*)malloc(graph->num_vertices * sizeof(int));
-    bool* visited = (bool*)calloc(graph->num_vertices, sizeof(bool));
+    graph_dijkstra_quiet(graph, src, distance, parent);
 
-    // Initialize: all distances = infinity, source = 0
-    for (int i = 0; i < graph->num_vertices; i++) {
-        distance[i] = INF;
-        parent[i] = -1;
-    }
-    distance[src] = 0;
-
-    // Main Dijkstra loop: process each vertex
-    for (int count = 0; count < graph->num_vertices; count++) {
-        // Find unvisited vertex with minimum distance
-        int min_dist = INF;
-        int u = -1;
-        for (int i = 0; i < graph->num_vertices; i++) {
-            if (!visited[i] && distance[i] < min_dist) {
-                min_dist = distance[i];
-                u = i;
-            }
-        }
-
-        // If no reachable unvisited vertex, done
-        if (u == -1 || min_dist == INF) break;
-
-        // Mark as visited
-        visited[u] = true;
-
-        // Early exit if we reached destination
-        if (dest >= 0 && u == dest) break;
-
-        // Relax edges: try to improve distance to neighbors
-        if (graph->representation == ADJACENCY_LIST) {
-            AdjListNode* node = graph->adj_list[u];
-            while (node != NULL) {
-                int v = node->dest;
-                int weight = node->weight;
-
-                // Relaxation: if path through u is shorter, update
-                if (!visited[v] && distance[u] != INF &&
-                    distance[u] + weight < distance[v]) {
-                    distance[v] = distance[u] + weight;
-                    parent[v] = u;
-                }
-                node = node->next;
-            }
-        } else {
-            for (int v = 0; v < graph->num_vertices; v++) {
-                int weight = graph->adj_matrix[u][v];
-                if (weight != NO_EDGE && !visited[v] && distance[u] != INF &&
-                    distance[u] + weight < distance[v]) {
-                    distance[v] = distance[u] + weight;
-                    parent[v] = u;
-                }
-            }
-        }
-    }
-
-    // Print results
-    if (dest >= 0) {
-        // Single destination
-        if (distance[dest] == INF) {
-            printf("No path found\n");
-        } else {
-            printf("Shortest path found!\n");
-            printf("Total weight: %d\n\n", distance[dest]);
-
-            // Reconstruct path
-            int* path = (int*)malloc(graph->num_vertices * sizeof(int));
-            int path_len = 0;
-            int current = dest;
-            while (current != -1) {
-                path[path_len++] = current;
-                current = parent[current];
-            }
-
-            // Print path with weights
-            printf("Path: ");
-            int total_weight = 0;
-            for (int i = path_len - 1; i >= 0; i--) {
-                printf("%d", path[i]);
-                if (i > 0) {
-                    int u = path[i];
-                    int v = path[i-1];
-                    int weight = get_edge_weight(graph, u, v);
-                    printf(" -(%d)-> ", weight);
-                    total_weight += weight;
-                }
-            }
-            printf("\n");
-            printf("Verification: Total weight = %d\n", total_weight);
-
-            free(path);
-        }
-    } else {
-        // All destinations
-        printf("Shortest paths from vertex %d:\n\n", src);
-        printf("Dest | Distance | Path\n");
-        printf("-----|----------|---------------------\n");
-
-        for (int i = 0; i < graph->num_vertices; i++) {
-            if (i == src) continue;
-
-            printf(" %2d  | ", i);
-
-            if (distance[i] == INF) {
-                printf("   INF   | No path\n");
-            } else {
-                printf("%6d   | ", distance[i]);
-
-                // Reconstruct path
-                int* path = (int*)malloc(graph->num_vertices * sizeof(int));
-                int path_len = 0;
-                int current = i;
-                while (current != -1) {
-                    path[path_len++] = current;
-                    current = parent[current];
-                }
-
-                // Print path
-                for (int j = path_len - 1; j >= 0; j--) {
-                    printf("%d", path[j]);
-                    if (j > 0) printf("->");
-                }
-                printf("\n");
-
-                free(path);
-            }
-        }
-    }
+    print_shortest_paths(graph, src, dest, distance, parent);
 
     free(distance);
     free(parent);
-    free(visited);
 }
 
 /**
@@ -1256,89 +1454,12 @@ void graph_bellman_ford(Graph* graph, int src, int dest) {
         return;
     }
 
-    // Arrays for Bellman-Ford
     int* distance = (int*)malloc(graph->num_vertices * sizeof(int));
     int* parent = (int*)malloc(graph->num_vertices * sizeof(int));
+    int passes = graph_bellman_ford_quiet(graph, src, distance, parent);
 
-    // Initialize: all distances = infinity, source = 0
-    for (int i = 0; i < graph->num_vertices; i++) {
-        distance[i] = INF;
-        parent[i] = -1;
-    }
-    distance[src] = 0;
-
-    // Main Bellman-Ford: Relax all edges (V-1) times
-    // Why V-1? Shortest path has at most V-1 edges
-    for (int iter = 0; iter < graph->num_vertices - 1; iter++) {
-        bool updated = false;
-
-        // Try to relax every edge in the graph
-        for (int u = 0; u < graph->num_vertices; u++) {
-            if (distance[u] == INF) continue;  // Skip unreachable vertices
-
-            if (graph->representation == ADJACENCY_LIST) {
-                AdjListNode* node = graph->adj_list[u];
-                while (node != NULL) {
-                    int v = node->dest;
-                    int weight = node->weight;
-
-                    // Relaxation: if path through u is shorter, update
-                    if (distance[u] + weight < distance[v]) {
-                        distance[v] = distance[u] + weight;
-                        parent[v] = u;
-                        updated = true;
-                    }
-                    node = node->next;
-                }
-            } else {
-                for (int v = 0; v < graph->num_vertices; v++) {
-                    int weight = graph->adj_matrix[u][v];
-                    if (weight != NO_EDGE && distance[u] + weight < distance[v]) {
-                        distance[v] = distance[u] + weight;
-                        parent[v] = u;
-                        updated = true;
-                    }
-                }
-            }
-        }
-
-        // Optimization: if no updates in this iteration, done early
-        if (!updated) {
-            printf("Converged after %d iterations (early exit)\n\n", iter + 1);
-            break;
-        }
-    }
-
-    // Negative cycle detection
-    // If we can still relax edges, negative cycle exists
-    bool has_negative_cycle = false;
-    for (int u = 0; u < graph->num_vertices; u++) {
-        if (distance[u] == INF) continue;
-
-        if (graph->representation == ADJACENCY_LIST) {
-            AdjListNode* node = graph->adj_list[u];
-            while (node != NULL) {
-                int v = node->dest;
-                int weight = node->weight;
-                if (distance[u] + weight < distance[v]) {
-                    has_negative_cycle = true;
-                    break;
-                }
-                node = node->next;
-            }
-        } else {
-            for (int v = 0; v < graph->num_vertices; v++) {
-                int weight = graph->adj_matrix[u][v];
-                if (weight != NO_EDGE && distance[u] + weight < distance[v]) {
-                    has_negative_cycle = true;
-                    break;
-                }
-            }
-        }
-        if (has_negative_cycle) break;
-    }
-
-    if (has_negative_cycle) {
+    // src is valid, so -1 means an edge still relaxed on pass V
+    if (passes < 0) {
         printf("❌ NEGATIVE CYCLE DETECTED!\n");
         printf("   No shortest path exists (can keep decreasing distance)\n");
         free(distance);
@@ -1346,79 +1467,13 @@ void graph_bellman_ford(Graph* graph, int src, int dest) {
         return;
     }
 
-    // Print results
-    if (dest >= 0) {
-        // Single destination
-        if (distance[dest] == INF) {
-            printf("No path found\n");
-        } else {
-            printf("Shortest path found!\n");
-            printf("Total weight: %d\n\n", distance[dest]);
-
-            // Reconstruct path
-            int* path = (int*)malloc(graph->num_vertices * sizeof(int));
-            int path_len = 0;
-            int current = dest;
-            while (current != -1) {
-                path[path_len++] = current;
-                current = parent[current];
-            }
-
-            // Print path with weights
-            printf("Path: ");
-            int total_weight = 0;
-            for (int i = path_len - 1; i >= 0; i--) {
-                printf("%d", path[i]);
-                if (i > 0) {
-                    int u = path[i];
-                    int v = path[i-1];
-                    int weight = get_edge_weight(graph, u, v);
-                    printf(" -(%d)-> ", weight);
-                    total_weight += weight;
-                }
-            }
-            printf("\n");
-            printf("Verification: Total weight = %d\n", total_weight);
-
-            free(path);
-        }
-    } else {
-        // All destinations
-        printf("Shortest paths from vertex %d:\n\n", src);
-        printf("Dest | Distance | Path\n");
-        printf("-----|----------|---------------------\n");
-
-        for (int i = 0; i < graph->num_vertices; i++) {
-            if (i == src) continue;
-
-            printf(" %2d  | ", i);
-
-            if (distance[i] == INF) {
-                printf("   INF   | No path\n");
-            } else {
-                printf("%6d   | ", distance[i]);
-
-                // Reconstruct path
-                int* path = (int*)malloc(graph->num_vertices * sizeof(int));
-                int path_len = 0;
-                int current = i;
-                while (current != -1) {
-                    path[path_len++] = current;
-                    current = parent[current];
-                }
-
-                // Print path
-                for (int j = path_len - 1; j >= 0; j--) {
-                    printf("%d", path[j]);
-                    if (j > 0) printf("->");
-                }
-                printf("\n");
-
-                free(path);
-            }
-        }
+    // A pass with no updates before the V-1 limit ends the search early
+    if (passes < graph->num_vertices) {
+        printf("Converged after %d iterations (early exit)\n\n", passes);
     }
 
+    print_shortest_paths(graph, src, dest, distance, parent);
+
     free(distance);
     free(parent);
 }
@@ -1709,77 +1764,9 @@ int** graph_floyd_warshall(Graph* graph) {
 
     int V = graph->num_vertices;
 
-    // Step 1: Initialize distance matrix
-    printf("Step 1: Initialize distance matrix\n");
-    int** dist = (int**)malloc(V * sizeof(int*));
-    for (int i = 0; i < V; i++) {
-        dist[i] = (int*)malloc(V * sizeof(int));
-        for (int j = 0; j < V; j++) {
-            if (i == j) {
-                dist[i][j] = 0;  // Distance to self = 0
-            } else if (graph->representation == ADJACENCY_MATRIX) {
-                dist[i][j] = graph->adj_matrix[i][j];
-            } else {
-                // For adjacency list, check if edge exists
-                dist[i][j] = INF;
-                AdjListNode* node = graph->adj_list[i];
-                while (node != NULL) {
-                    if (node->dest == j) {
-                        dist[i][j] = node->weight;
-                        break;
-                    }
-                    node = node->next;
-                }
-            }
-        }
-    }
-
-    printf("Initial distance matrix (direct edges only):\n");
-    printf("     ");
-    for (int j = 0; j < V; j++) {
-        printf("%5d ", j);
-    }
-    printf("\n");
-    for (int i = 0; i < V; i++) {
-        printf("%2d:  ", i);
-        for (int j = 0; j < V; j++) {
-            if (dist[i][j] == INF) {
-                printf("  INF ");
-            } else {
-                printf("%5d ", dist[i][j]);
-            }
-        }
-        printf("\n");
-    }
-    printf("\n");
-
-    // Step 2: Dynamic Programming - consider each vertex as intermediate
-    printf("Step 2: Try all intermediate vertices\n\n");
-
-    for (int k = 0; k < V; k++) {
-        printf("Iteration k=%d: Consider paths through vertex %d\n", k, k);
-
-        int updates = 0;
-        for (int i = 0; i < V; i++) {
-            for (int j = 0; j < V; j++) {
-                // Can we improve path i→j by going through k?
-                if (dist[i][k] != INF && dist[k][j] != INF) {
-                    int new_dist = dist[i][k] + dist[k][j];
-                    if (new_dist < dist[i][j]) {
-                        printf("  Update dist[%d][%d]: %d → %d (via %d)\n",
-                               i, j, dist[i][j], new_dist, k);
-                        dist[i][j] = new_dist;
-                        updates++;
-                    }
-                }
-            }
-        }
-
-        if (updates == 0) {
-            printf("  (no improvements)\n");
-        }
-        printf("\n");
-    }
+    // Steps 1-2: direct edges, then every pair through each intermediate k
+    int** dist = graph_floyd_warshall_quiet(graph);
+    printf("Steps 1-2: Start from direct edges, then try all %d vertices as intermediates\n\n", V);
 
     // Step 3: Check for negative cycles
     printf("Step 3: Check for negative cycles\n");
@@ -1933,15 +1920,6 @@ void uf_destroy(UnionFind* uf) {
     free(uf);
 }
 
-// ------------------------------------------------------------
-// Edge structure for MST algorithms
-// ------------------------------------------------------------
-
-typedef struct {
-    int u, v;      // Edge endpoints
-    int weight;    // Edge weight
-} Edge;
-
 /**
  * Comparison function for sorting edges by weight (for Kruskal's)
  */
@@ -1995,109 +1973,28 @@ Edge* graph_prim_mst(Graph* graph, int* mst_size) {
 
     printf("\n=== Prim's Algorithm - Minimum Spanning Tree ===\n\n");
 
-    int V = graph->num_vertices;
-
-    // Arrays for Prim's algorithm
-    int* key = (int*)malloc(V * sizeof(int));        // Minimum weight to include vertex
-    int* parent = (int*)malloc(V * sizeof(int));     // Parent vertex in MST
-    bool* in_mst = (bool*)calloc(V, sizeof(bool));   // Whether vertex in MST
+    Edge* mst = graph_prim_mst_quiet(graph, mst_size);
 
-    // Initialize: all keys = infinity, no parents
-    for (int i = 0; i < V; i++) {
-        key[i] = INF;
-        parent[i] = -1;
+    // Each vertex joined the tree through its cheapest edge into it
+    printf("Grown from vertex 0; edge that brought in each vertex:\n\n");
+    int total_weight = 0;
+    for (int i = 0; i < *mst_size; i++) {
+        printf("  Vertex %d via edge %d-%d (weight: %d)\n",
+               mst[i].v, mst[i].u, mst[i].v, mst[i].weight);
+        total_weight += mst[i].weight;
     }
+    printf("\n");
 
-    // Start from vertex 0
-    key[0] = 0;  // Start vertex has key 0 so it's picked first
-
-    printf("Step-by-step construction:\n\n");
-    int step = 0;
-
-    // Build MST with V-1 edges
-    for (int count = 0; count < V; count++) {
-        // Find vertex with minimum key that's not in MST
-        int min_key = INF;
-        int u = -1;
-        for (int v = 0; v < V; v++) {
-            if (!in_mst[v] && key[v] < min_key) {
-                min_key = key[v];
-                u = v;
-            }
-        }
-
-        if (u == -1) break;  // No more reachable vertices
+    printf("Prim's MST Complete!\n");
+    printf("Total MST weight: %d\n", total_weight);
+    printf("Edges in MST: %d\n", *mst_size);
 
-        // Add vertex to MST
-        in_mst[u] = true;
+    return mst;
+}
 
-        // Print step
-        if (parent[u] != -1) {
-            printf("Step %d: Add edge %d-%d (weight: %d)\n",
-                   ++step, parent[u], u, key[u]);
-            printf("        MST now includes vertices: ");
-            for (int i = 0; i < V; i++) {
-                if (in_mst[i]) printf("%d ", i);
-            }
-            printf("\n\n");
-        } else {
-            printf("Step %d: Start at vertex %d\n\n", ++step, u);
-        }
-
-        // Update keys of adjacent vertices
-        if (graph->representation == ADJACENCY_LIST) {
-            AdjListNode* node = graph->adj_list[u];
-            while (node != NULL) {
-                int v = node->dest;
-                int weight = node->weight;
-
-                // If v not in MST and weight is smaller than current key
-                if (!in_mst[v] && weight < key[v]) {
-                    key[v] = weight;
-                    parent[v] = u;
-                }
-                node = node->next;
-            }
-        } else {
-            for (int v = 0; v < V; v++) {
-                int weight = graph->adj_matrix[u][v];
-                if (weight != NO_EDGE && !in_mst[v] && weight < key[v]) {
-                    key[v] = weight;
-                    parent[v] = u;
-                }
-            }
-        }
-    }
-
-    // Build MST edge array
-    Edge* mst = (Edge*)malloc((V - 1) * sizeof(Edge));
-    *mst_size = 0;
-    int total_weight = 0;
-
-    for (int v = 1; v < V; v++) {
-        if (parent[v] != -1) {
-            mst[*mst_size].u = parent[v];
-            mst[*mst_size].v = v;
-            mst[*mst_size].weight = key[v];
-            total_weight += key[v];
-            (*mst_size)++;
-        }
-    }
-
-    printf("Prim's MST Complete!\n");
-    printf("Total MST weight: %d\n", total_weight);
-    printf("Edges in MST: %d\n", *mst_size);
-
-    free(key);
-    free(parent);
-    free(in_mst);
-
-    return mst;
-}
-
-// ------------------------------------------------------------
-// Kruskal's Algorithm - Minimum Spanning Tree
-// ------------------------------------------------------------
+// ------------------------------------------------------------
+// Kruskal's Algorithm - Minimum Spanning Tree
+// ------------------------------------------------------------
 
 /**
  * Kruskal's Algorithm for Minimum Spanning Tree
@@ -2139,115 +2036,3622 @@ Edge* graph_kruskal_mst(Graph* graph, int* mst_size) {
         return NULL;
     }
 
-    printf("\n=== Kruskal's Algorithm - Minimum Spanning Tree ===\n\n");
+    printf("\n=== Kruskal's Algorithm - Minimum Spanning Tree ===\n\n");
+
+    Edge* mst = graph_kruskal_mst_quiet(graph, mst_size);
+
+    // The core keeps edges in the order union-find accepted them
+    printf("Edges added in weight order (cycle-closing edges skipped):\n\n");
+    int total_weight = 0;
+    for (int i = 0; i < *mst_size; i++) {
+        printf("Step %d: ✓ ADDED %d-%d (weight: %d)\n",
+               i + 1, mst[i].u, mst[i].v, mst[i].weight);
+        total_weight += mst[i].weight;
+    }
+
+    printf("\nKruskal's MST Complete!\n");
+    printf("Total MST weight: %d\n", total_weight);
+    printf("Edges in MST: %d\n", *mst_size);
+
+    return mst;
+}
+
+/**
+ * Display MST edges
+ */
+void display_mst(Edge* mst, int mst_size) {
+    printf("\nMST Edges:\n");
+    int total = 0;
+    for (int i = 0; i < mst_size; i++) {
+        printf("  %d -- %d  (weight: %d)\n", mst[i].u, mst[i].v, mst[i].weight);
+        total += mst[i].weight;
+    }
+    printf("\nTotal weight: %d\n", total);
+}
+
+// ------------------------------------------------------------
+// Quiet cores - the one body of each algorithm
+// ------------------------------------------------------------
+
+/**
+ * Silent Cores
+ *
+ * Each algorithm above is written once, here. The narrated functions
+ * call these and then print the results, and bench_graphs times these
+ * directly, where formatting the text would cost more than the
+ * algorithm. An optimization made here shows up in both.
+ *
+ * The single-source searches fill parent[] (the previous vertex on each
+ * shortest path, -1 for src and unreachable vertices) when it is not
+ * NULL, which is what the narrated versions print paths from.
+ */
+
+/**
+ * BFS hop counts from src to every vertex (INF if unreachable)
+ *
+ * @return false if src is out of range
+ */
+bool graph_bfs_quiet(Graph* graph, int src, int* distance, int* parent) {
+    int V = graph->num_vertices;
+    if (src < 0 || src >= V) return false;
+
+    int* queue = (int*)malloc(V * sizeof(int));
+    for (int i = 0; i < V; i++) distance[i] = INF;
+    if (parent) for (int i = 0; i < V; i++) parent[i] = -1;
+    distance[src] = 0;
+    int front = 0, rear = 0;
+    queue[rear++] = src;
+
+    while (front < rear) {
+        int u = queue[front++];
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                if (distance[node->dest] == INF) {
+                    distance[node->dest] = distance[u] + 1;
+                    if (parent) parent[node->dest] = u;
+                    queue[rear++] = node->dest;
+                }
+            }
+        } else {
+            for (int v = 0; v < V; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE && distance[v] == INF) {
+                    distance[v] = distance[u] + 1;
+                    if (parent) parent[v] = u;
+                    queue[rear++] = v;
+                }
+            }
+        }
+    }
+
+    free(queue);
+    return true;
+}
+
+/**
+ * Dijkstra (O(V²) array version) from src to every vertex
+ *
+ * @return false if src is out of range
+ */
+bool graph_dijkstra_quiet(Graph* graph, int src, int* distance, int* parent) {
+    int V = graph->num_vertices;
+    if (src < 0 || src >= V) return false;
+
+    bool* visited = (bool*)calloc(V, sizeof(bool));
+    for (int i = 0; i < V; i++) distance[i] = INF;
+    if (parent) for (int i = 0; i < V; i++) parent[i] = -1;
+    distance[src] = 0;
+
+    for (int count = 0; count < V; count++) {
+        int u = -1;
+        for (int i = 0; i < V; i++) {
+            if (!visited[i] && distance[i] != INF && (u == -1 || distance[i] < distance[u])) u = i;
+        }
+        if (u == -1) break;
+        visited[u] = true;
+
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                int v = node->dest;
+                if (!visited[v] && distance[u] + node->weight < distance[v]) {
+                    distance[v] = distance[u] + node->weight;
+                    if (parent) parent[v] = u;
+                }
+            }
+        } else {
+            for (int v = 0; v < V; v++) {
+                int weight = graph->adj_matrix[u][v];
+                if (weight != NO_EDGE && !visited[v] && distance[u] + weight < distance[v]) {
+                    distance[v] = distance[u] + weight;
+                    if (parent) parent[v] = u;
+                }
+            }
+        }
+    }
+
+    free(visited);
+    return true;
+}
+
+/**
+ * Bellman-Ford from src to every vertex, with early exit
+ *
+ * @return Passes over the edges, or -1 if src is out of range or a
+ *         negative cycle is reachable
+ */
+int graph_bellman_ford_quiet(Graph* graph, int src, int* distance, int* parent) {
+    int V = graph->num_vertices;
+    if (src < 0 || src >= V) return -1;
+
+    for (int i = 0; i < V; i++) distance[i] = INF;
+    if (parent) for (int i = 0; i < V; i++) parent[i] = -1;
+    distance[src] = 0;
+
+    // Pass V (if reached) is the negative-cycle check
+    int passes = 0;
+    bool updated = true;
+    while (updated && passes < V) {
+        updated = false;
+        passes++;
+        for (int u = 0; u < V; u++) {
+            if (distance[u] == INF) continue;
+            if (graph->representation == ADJACENCY_LIST) {
+                for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                    if (distance[u] + node->weight < distance[node->dest]) {
+                        distance[node->dest] = distance[u] + node->weight;
+                        if (parent) parent[node->dest] = u;
+                        updated = true;
+                    }
+                }
+            } else {
+                for (int v = 0; v < V; v++) {
+                    int weight = graph->adj_matrix[u][v];
+                    if (weight != NO_EDGE && distance[u] + weight < distance[v]) {
+                        distance[v] = distance[u] + weight;
+                        if (parent) parent[v] = u;
+                        updated = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return updated ? -1 : passes;
+}
+
+/**
+ * Floyd-Warshall all-pairs distances (free with floyd_warshall_free)
+ */
+int** graph_floyd_warshall_quiet(Graph* graph) {
+    int V = graph->num_vertices;
+    int** dist = (int**)malloc(V * sizeof(int*));
+    for (int i = 0; i < V; i++) {
+        dist[i] = (int*)malloc(V * sizeof(int));
+        for (int j = 0; j < V; j++) {
+            int weight = graph->representation == ADJACENCY_MATRIX ? graph->adj_matrix[i][j] : NO_EDGE;
+            dist[i][j] = weight != NO_EDGE ? weight : INF;
+        }
+        if (graph->representation == ADJACENCY_LIST) {
+            // One pass over the list; the first arc to a vertex wins
+            for (AdjListNode* node = graph->adj_list[i]; node != NULL; node = node->next) {
+                if (dist[i][node->dest] == INF) dist[i][node->dest] = node->weight;
+            }
+        }
+        dist[i][i] = 0;
+    }
+
+    for (int k = 0; k < V; k++) {
+        const int* row_k = dist[k];
+        for (int i = 0; i < V; i++) {
+            int d_ik = dist[i][k];
+            if (d_ik == INF) continue;
+            int* row_i = dist[i];
+            for (int j = 0; j < V; j++) {
+                if (row_k[j] != INF && d_ik + row_k[j] < row_i[j]) row_i[j] = d_ik + row_k[j];
+            }
+        }
+    }
+    return dist;
+}
+
+/**
+ * Prim's MST (O(V²) array version), grown from vertex 0
+ *
+ * @return MST edges (caller frees), or NULL if the graph is DIRECTED
+ */
+Edge* graph_prim_mst_quiet(Graph* graph, int* mst_size) {
+    if (graph->type == DIRECTED) return NULL;
+
+    int V = graph->num_vertices;
+    int* key = (int*)malloc(V * sizeof(int));
+    int* parent = (int*)malloc(V * sizeof(int));
+    bool* in_mst = (bool*)calloc(V, sizeof(bool));
+    for (int i = 0; i < V; i++) {
+        key[i] = INF;
+        parent[i] = -1;
+    }
+    if (V > 0) key[0] = 0;
+
+    for (int count = 0; count < V; count++) {
+        int u = -1;
+        for (int v = 0; v < V; v++) {
+            if (!in_mst[v] && key[v] != INF && (u == -1 || key[v] < key[u])) u = v;
+        }
+        if (u == -1) break;
+        in_mst[u] = true;
+
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                if (!in_mst[node->dest] && node->weight < key[node->dest]) {
+                    key[node->dest] = node->weight;
+                    parent[node->dest] = u;
+                }
+            }
+        } else {
+            for (int v = 0; v < V; v++) {
+                int weight = graph->adj_matrix[u][v];
+                if (weight != NO_EDGE && !in_mst[v] && weight < key[v]) {
+                    key[v] = weight;
+                    parent[v] = u;
+                }
+            }
+        }
+    }
+
+    Edge* mst = (Edge*)malloc((V > 1 ? V - 1 : 1) * sizeof(Edge));
+    *mst_size = 0;
+    for (int v = 1; v < V; v++) {
+        if (parent[v] != -1) mst[(*mst_size)++] = (Edge){parent[v], v, key[v]};
+    }
+
+    free(key);
+    free(parent);
+    free(in_mst);
+    return mst;
+}
+
+/**
+ * Kruskal's MST (sort + union-find)
+ *
+ * @return MST edges in the order they were added (caller frees), or
+ *         NULL if the graph is DIRECTED
+ */
+Edge* graph_kruskal_mst_quiet(Graph* graph, int* mst_size) {
+    if (graph->type == DIRECTED) return NULL;
+
+    int V = graph->num_vertices;
+    Edge* edges = (Edge*)malloc((graph->num_edges > 0 ? graph->num_edges : 1) * sizeof(Edge));
+    int edge_count = 0;
+    for (int u = 0; u < V; u++) {
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                if (u < node->dest) edges[edge_count++] = (Edge){u, node->dest, node->weight};
+            }
+        } else {
+            for (int v = u + 1; v < V; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE) {
+                    edges[edge_count++] = (Edge){u, v, graph->adj_matrix[u][v]};
+                }
+            }
+        }
+    }
+    qsort(edges, edge_count, sizeof(Edge), compare_edges);
+
+    UnionFind* uf = uf_create(V);
+    Edge* mst = (Edge*)malloc((V > 1 ? V - 1 : 1) * sizeof(Edge));
+    *mst_size = 0;
+    for (int i = 0; i < edge_count && *mst_size < V - 1; i++) {
+        if (uf_union(uf, edges[i].u, edges[i].v)) mst[(*mst_size)++] = edges[i];
+    }
+
+    free(edges);
+    uf_destroy(uf);
+    return mst;
+}
+
+// ============================================================
+// CENTRALITY - Brandes Betweenness
+// ============================================================
+
+// ------------------------------------------------------------
+// Binary min-heap of (distance, vertex) pairs
+// Used by Dijkstra-style searches that need O((V+E) log V)
+// ------------------------------------------------------------
+
+/**
+ * Min-heap with lazy deletion
+ *
+ * Instead of supporting decrease-key, we push a new (dist, vertex) pair
+ * every time a distance improves and skip stale pairs when popped
+ * (popped dist > current best dist for that vertex).
+ *
+ * Push/Pop: O(log n)
+ */
+typedef struct {
+    int vertex;
+    int dist;
+} HeapItem;
+
+typedef struct {
+    HeapItem* items;
+    int size;
+    int capacity;
+} MinHeap;
+
+void min_heap_init(MinHeap* heap, int capacity) {
+    heap->capacity = capacity > 0 ? capacity : 16;
+    heap->size = 0;
+    heap->items = (HeapItem*)malloc(heap->capacity * sizeof(HeapItem));
+}
+
+void min_heap_free(MinHeap* heap) {
+    free(heap->items);
+    heap->items = NULL;
+    heap->size = heap->capacity = 0;
+}
+
+void min_heap_push(MinHeap* heap, int vertex, int dist) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->items = (HeapItem*)realloc(heap->items, heap->capacity * sizeof(HeapItem));
+    }
+
+    // Percolate up
+    int i = heap->size++;
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (heap->items[p].dist <= dist) break;
+        heap->items[i] = heap->items[p];
+        i = p;
+    }
+    heap->items[i].vertex = vertex;
+    heap->items[i].dist = dist;
+}
+
+HeapItem min_heap_pop(MinHeap* heap) {
+    HeapItem top = heap->items[0];
+    HeapItem last = heap->items[--heap->size];
+
+    // Percolate down
+    int i = 0;
+    while (2 * i + 1 < heap->size) {
+        int c = 2 * i + 1;
+        if (c + 1 < heap->size && heap->items[c + 1].dist < heap->items[c].dist) c++;
+        if (last.dist <= heap->items[c].dist) break;
+        heap->items[i] = heap->items[c];
+        i = c;
+    }
+    if (heap->size > 0) heap->items[i] = last;
+    return top;
+}
+
+/**
+ * Wall-clock time in seconds (clock() sums CPU time across threads)
+ */
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ------------------------------------------------------------
+// Brandes' algorithm
+// ------------------------------------------------------------
+
+/**
+ * Betweenness Centrality (Brandes' Algorithm)
+ *
+ * What is it?
+ * -----------
+ * CB(v) = Σ σ_st(v) / σ_st   over all pairs s ≠ v ≠ t
+ *
+ * σ_st    = number of shortest s→t paths
+ * σ_st(v) = number of those paths passing through v
+ *
+ * High betweenness = vertex sits on many shortest paths (bottleneck,
+ * bridge between communities, critical router in a network).
+ *
+ * Brandes' insight: dependencies can be accumulated backwards
+ * ----------------------------------------------------------
+ * For a fixed source s, define δ_s(v) = Σ_t σ_st(v) / σ_st. Then
+ *
+ *   δ_s(v) = Σ_{w : v is a predecessor of w} σ_sv / σ_sw × (1 + δ_s(w))
+ *
+ * So one single-source search + one reverse sweep gives every δ_s(v):
+ * 1. BFS (unweighted) or Dijkstra (weighted) from s, recording
+ *    σ (path counts) and the order in which vertices are settled
+ * 2. Walk the settle order backwards; for each edge v→w on a shortest
+ *    path (dist[w] == dist[v] + weight) add σ_v/σ_w × (1 + δ_w) to δ_v
+ * 3. CB(v) += δ_s(v)
+ *
+ * Walking successors instead of storing predecessor lists keeps the
+ * per-source workspace to a handful of O(V) arrays.
+ *
+ * Parallelization:
+ * ----------------
+ * Sources are independent. Each thread owns a private workspace and a
+ * private CB accumulator, claims sources from a shared atomic counter,
+ * and the per-thread accumulators are summed once at the end. There is
+ * no sharing (and no locking) on the hot path.
+ *
+ * Sampling (k sources):
+ * ---------------------
+ * Running from k random sources and scaling by V/k gives an unbiased
+ * estimate - O(k(V+E)) instead of O(V(V+E)).
+ *
+ * Time: O(V·E) unweighted, O(V·E log V) weighted (÷ threads)
+ * Space: O(V) per thread
+ *
+ * NOTE: Weighted graphs must have POSITIVE weights (zero-weight edges
+ *       break the path counting, negative weights break Dijkstra).
+ */
+typedef struct {
+    Graph* graph;
+    const int* sources;          // Sources to process
+    int num_sources;
+    atomic_int* next_source;     // Shared work counter
+
+    // Private per-thread workspace
+    int* order;                  // Vertices in non-decreasing distance order
+    int* dist;
+    double* sigma;               // Number of shortest paths from source
+    double* delta;               // Dependency of source on vertex
+    MinHeap heap;
+    double* centrality;          // Private accumulator (reduced at the end)
+} BrandesWorker;
+
+/**
+ * Single-source phase: fills order[], dist[], sigma[]
+ * Returns number of vertices reached
+ */
+static int brandes_single_source(BrandesWorker* w, int s) {
+    Graph* graph = w->graph;
+    int count = 0;
+
+    w->dist[s] = 0;
+    w->sigma[s] = 1.0;
+
+    if (graph->weight_type == UNWEIGHTED) {
+        // BFS: dequeue order == settle order, so the queue IS the order
+        int front = 0;
+        w->order[count++] = s;
+
+        while (front < count) {
+            int u = w->order[front++];
+
+            if (graph->representation == ADJACENCY_LIST) {
+                for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                    int v = node->dest;
+                    if (w->dist[v] == INF) {
+                        w->dist[v] = w->dist[u] + 1;
+                        w->order[count++] = v;
+                    }
+                    if (w->dist[v] == w->dist[u] + 1) {
+                        w->sigma[v] += w->sigma[u];
+                    }
+                }
+            } else {
+                for (int v = 0; v < graph->num_vertices; v++) {
+                    if (graph->adj_matrix[u][v] == NO_EDGE) continue;
+                    if (w->dist[v] == INF) {
+                        w->dist[v] = w->dist[u] + 1;
+                        w->order[count++] = v;
+                    }
+                    if (w->dist[v] == w->dist[u] + 1) {
+                        w->sigma[v] += w->sigma[u];
+                    }
+                }
+            }
+        }
+    } else {
+        // Dijkstra with lazy-deletion heap; record vertices as they settle
+        w->heap.size = 0;
+        min_heap_push(&w->heap, s, 0);
+
+        while (w->heap.size > 0) {
+            HeapItem item = min_heap_pop(&w->heap);
+            int u = item.vertex;
+            if (item.dist > w->dist[u]) continue;  // Stale entry
+            w->order[count++] = u;
+
+            if (graph->representation == ADJACENCY_LIST) {
+                for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                    int v = node->dest;
+                    int nd = w->dist[u] + node->weight;
+                    if (nd < w->dist[v]) {
+                        w->dist[v] = nd;
+                        w->sigma[v] = w->sigma[u];
+                        min_heap_push(&w->heap, v, nd);
+                    } else if (nd == w->dist[v]) {
+                        w->sigma[v] += w->sigma[u];
+                    }
+                }
+            } else {
+                for (int v = 0; v < graph->num_vertices; v++) {
+                    int weight = graph->adj_matrix[u][v];
+                    if (weight == NO_EDGE) continue;
+                    int nd = w->dist[u] + weight;
+                    if (nd < w->dist[v]) {
+                        w->dist[v] = nd;
+                        w->sigma[v] = w->sigma[u];
+                        min_heap_push(&w->heap, v, nd);
+                    } else if (nd == w->dist[v]) {
+                        w->sigma[v] += w->sigma[u];
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Dependency accumulation: reverse sweep over settle order
+ * Also resets the touched entries so the next source starts clean
+ * without an O(V) clear.
+ */
+static void brandes_accumulate(BrandesWorker* w, int s, int count) {
+    Graph* graph = w->graph;
+
+    for (int i = count - 1; i >= 0; i--) {
+        int v = w->order[i];
+        double coeff = 0.0;
+
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[v]; node != NULL; node = node->next) {
+                int x = node->dest;
+                if (w->dist[x] != INF && w->dist[x] == w->dist[v] + node->weight) {
+                    coeff += (1.0 + w->delta[x]) / w->sigma[x];
+                }
+            }
+        } else {
+            for (int x = 0; x < graph->num_vertices; x++) {
+                int weight = graph->adj_matrix[v][x];
+                if (weight != NO_EDGE && w->dist[x] != INF &&
+                    w->dist[x] == w->dist[v] + weight) {
+                    coeff += (1.0 + w->delta[x]) / w->sigma[x];
+                }
+            }
+        }
+
+        w->delta[v] = w->sigma[v] * coeff;
+        if (v != s) {
+            w->centrality[v] += w->delta[v];
+        }
+    }
+
+    // Reset only what we touched
+    for (int i = 0; i < count; i++) {
+        int v = w->order[i];
+        w->dist[v] = INF;
+        w->sigma[v] = 0.0;
+        w->delta[v] = 0.0;
+    }
+}
+
+static void* brandes_worker_run(void* arg) {
+    BrandesWorker* w = (BrandesWorker*)arg;
+
+    while (1) {
+        int i = atomic_fetch_add(w->next_source, 1);
+        if (i >= w->num_sources) break;
+
+        int s = w->sources[i];
+        int count = brandes_single_source(w, s);
+        brandes_accumulate(w, s, count);
+    }
+
+    return NULL;
+}
+
+/**
+ * Run Brandes from the given sources on num_threads threads
+ *
+ * @param scale  Multiplier applied to the result (V/k for sampling)
+ * @return       Centrality array of size V (caller frees)
+ */
+static double* betweenness_run(Graph* graph, const int* sources, int num_sources,
+                               int num_threads, double scale) {
+    int V = graph->num_vertices;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > num_sources && num_sources > 0) num_threads = num_sources;
+
+    atomic_int next_source;
+    atomic_init(&next_source, 0);
+
+    BrandesWorker* workers = (BrandesWorker*)calloc(num_threads, sizeof(BrandesWorker));
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+
+    for (int t = 0; t < num_threads; t++) {
+        BrandesWorker* w = &workers[t];
+        w->graph = graph;
+        w->sources = sources;
+        w->num_sources = num_sources;
+        w->next_source = &next_source;
+        w->order = (int*)malloc(V * sizeof(int));
+        w->dist = (int*)malloc(V * sizeof(int));
+        w->sigma = (double*)calloc(V, sizeof(double));
+        w->delta = (double*)calloc(V, sizeof(double));
+        w->centrality = (double*)calloc(V, sizeof(double));
+        min_heap_init(&w->heap, V);
+        for (int i = 0; i < V; i++) {
+            w->dist[i] = INF;
+        }
+    }
+
+    // Thread 0 work is done on the calling thread
+    for (int t = 1; t < num_threads; t++) {
+        pthread_create(&threads[t], NULL, brandes_worker_run, &workers[t]);
+    }
+    brandes_worker_run(&workers[0]);
+    for (int t = 1; t < num_threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    // Reduce per-thread accumulators
+    double* centrality = (double*)calloc(V, sizeof(double));
+    for (int t = 0; t < num_threads; t++) {
+        BrandesWorker* w = &workers[t];
+        for (int i = 0; i < V; i++) {
+            centrality[i] += w->centrality[i];
+        }
+        free(w->order);
+        free(w->dist);
+        free(w->sigma);
+        free(w->delta);
+        free(w->centrality);
+        min_heap_free(&w->heap);
+    }
+
+    // Undirected: every path counted once from each endpoint
+    if (graph->type == UNDIRECTED) {
+        scale /= 2.0;
+    }
+    for (int i = 0; i < V; i++) {
+        centrality[i] *= scale;
+    }
+
+    free(workers);
+    free(threads);
+    return centrality;
+}
+
+/**
+ * Exact betweenness centrality (all V sources)
+ *
+ * @param graph        Graph (unweighted → BFS, weighted → Dijkstra)
+ * @param num_threads  Number of worker threads (>= 1)
+ * @return             Array of V centrality scores (caller frees)
+ */
+double* graph_betweenness_centrality(Graph* graph, int num_threads) {
+    int V = graph->num_vertices;
+    int* sources = (int*)malloc(V * sizeof(int));
+    for (int i = 0; i < V; i++) {
+        sources[i] = i;
+    }
+
+    double* centrality = betweenness_run(graph, sources, V, num_threads, 1.0);
+
+    free(sources);
+    return centrality;
+}
+
+/**
+ * Approximate betweenness centrality from k sampled sources
+ *
+ * Sources are drawn without replacement (partial Fisher-Yates shuffle)
+ * and the result is scaled by V/k.
+ *
+ * @param num_sources  k - number of sampled sources (clamped to [1, V])
+ * @param seed         Seed for reproducible sampling
+ * @return             Array of V scores (caller frees), NULL if V == 0
+ */
+double* graph_betweenness_centrality_sampled(Graph* graph, int num_sources,
+                                             int num_threads, unsigned int seed) {
+    int V = graph->num_vertices;
+    if (V == 0) return NULL;     // No source to sample
+    if (num_sources < 1) num_sources = 1;
+    if (num_sources > V) num_sources = V;
+
+    int* perm = (int*)malloc(V * sizeof(int));
+    for (int i = 0; i < V; i++) {
+        perm[i] = i;
+    }
+    for (int i = 0; i < num_sources; i++) {
+        int j = i + (int)(rand_r(&seed) % (unsigned int)(V - i));
+        int tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+    }
+
+    double* centrality = betweenness_run(graph, perm, num_sources, num_threads,
+                                         (double)V / num_sources);
+
+    free(perm);
+    return centrality;
+}
+
+// ============================================================
+// COMPRESSED GRAPH - Gap-encoded varint adjacency (read-only)
+// ============================================================
+
+/**
+ * Compressed Sparse Adjacency (read-only)
+ *
+ * Why?
+ * ----
+ * An AdjListNode costs 16 bytes (dest + weight + next pointer) plus
+ * ~16 bytes of malloc header - about 32 bytes per edge, scattered
+ * across the heap. Large graphs simply do not fit in RAM that way.
+ *
+ * Idea (same trick as WebGraph / Ligra+):
+ * ---------------------------------------
+ * 1. Sort each vertex's neighbors: [1003, 1007, 1010, 5020]
+ * 2. Store GAPS instead of IDs:   [1003,    4,    3, 4010]
+ *    (first entry stored relative to the vertex itself, zigzag-signed)
+ * 3. Write each gap as a VARINT: 7 bits per byte, high bit = "more"
+ *    small gaps → 1 byte, gaps < 16384 → 2 bytes, ...
+ *
+ * Layout per vertex:  [degree][first][gap][gap]...   (all varints)
+ * Weighted graphs interleave a zigzag varint weight after each neighbor.
+ *
+ *   offsets: [0, 7, 7, 15, ...]       (V+1 byte offsets)
+ *   data:    contiguous byte stream   (one allocation for all edges)
+ *
+ * Typical cost: 1-3 bytes per unweighted edge, 2-4 bytes weighted.
+ *
+ * Access is SEQUENTIAL ONLY (decode neighbors of u in order), which is
+ * exactly what BFS, Dijkstra and PageRank need. There is no edge
+ * insertion or random access - build once, then query.
+ *
+ * Space: O(V) offsets + ~2-4 bytes per edge
+ */
+typedef struct {
+    GraphType type;
+    WeightType weight_type;
+    int num_vertices;
+    int num_edges;               // Logical edges (same meaning as Graph)
+    long long num_arcs;          // Stored directed arcs (2x edges if undirected)
+    uint64_t* offsets;           // offsets[v]..offsets[v+1]: byte range of v
+    uint8_t* data;               // Varint stream
+    size_t data_size;
+} CompressedGraph;
+
+/**
+ * Sequential neighbor decoder
+ *
+ * Usage:
+ *   CGIterator it;
+ *   int v, w;
+ *   cgraph_iter_begin(cg, u, &it);
+ *   while (cgraph_iter_next(&it, &v, &w)) { ... }
+ */
+typedef struct {
+    const uint8_t* p;            // Read cursor
+    int remaining;               // Neighbors left to decode
+    int prev;                    // Previous neighbor (gap base)
+    bool first;                  // Next value is relative to u, not a gap
+    bool weighted;
+} CGIterator;
+
+// ------------------------------------------------------------
+// Varint / zigzag helpers
+// ------------------------------------------------------------
+
+static inline uint64_t zigzag_encode(int64_t x) {
+    return ((uint64_t)x << 1) ^ (uint64_t)(x >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t x) {
+    return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+}
+
+static inline uint64_t varint_decode(const uint8_t** p) {
+    const uint8_t* q = *p;
+    uint64_t x = *q & 0x7F;
+    int shift = 7;
+    while (*q++ & 0x80) {
+        x |= (uint64_t)(*q & 0x7F) << shift;
+        shift += 7;
+    }
+    *p = q;
+    return x;
+}
+
+/**
+ * Growable byte buffer used while encoding
+ */
+typedef struct {
+    uint8_t* bytes;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+static void byte_buffer_varint(ByteBuffer* buf, uint64_t x) {
+    if (buf->size + 10 > buf->capacity) {
+        buf->capacity = buf->capacity * 2 + 64;
+        buf->bytes = (uint8_t*)realloc(buf->bytes, buf->capacity);
+    }
+    while (x >= 0x80) {
+        buf->bytes[buf->size++] = (uint8_t)(x | 0x80);
+        x >>= 7;
+    }
+    buf->bytes[buf->size++] = (uint8_t)x;
+}
+
+// ------------------------------------------------------------
+// Iteration
+// ------------------------------------------------------------
+
+static inline void cgraph_iter_begin(const CompressedGraph* cg, int u, CGIterator* it) {
+    it->p = cg->data + cg->offsets[u];
+    it->remaining = (int)varint_decode(&it->p);
+    it->prev = u;
+    it->first = true;
+    it->weighted = cg->weight_type == WEIGHTED;
+}
+
+static inline bool cgraph_iter_next(CGIterator* it, int* dest, int* weight) {
+    if (it->remaining == 0) return false;
+    it->remaining--;
+
+    uint64_t raw = varint_decode(&it->p);
+    if (it->first) {
+        it->prev += (int)zigzag_decode(raw);
+        it->first = false;
+    } else {
+        it->prev += (int)raw;
+    }
+    *dest = it->prev;
+    *weight = it->weighted ? (int)zigzag_decode(varint_decode(&it->p)) : 1;
+    return true;
+}
+
+static inline int cgraph_degree(const CompressedGraph* cg, int u) {
+    const uint8_t* p = cg->data + cg->offsets[u];
+    return (int)varint_decode(&p);
+}
+
+// ------------------------------------------------------------
+// Construction
+// ------------------------------------------------------------
+
+/**
+ * Comparison function for sorting arcs by (source, destination, weight)
+ *
+ * qsort is not stable, so the weight tie-break is what makes the
+ * duplicate kept by the encoder deterministic (the lightest one).
+ */
+int compare_arcs(const void* a, const void* b) {
+    const Edge* x = (const Edge*)a;
+    const Edge* y = (const Edge*)b;
+    if (x->u != y->u) return x->u < y->u ? -1 : 1;
+    if (x->v != y->v) return x->v < y->v ? -1 : 1;
+    if (x->weight != y->weight) return x->weight < y->weight ? -1 : 1;
+    return 0;
+}
+
+// Empty CompressedGraph to append vertices to, in order (NULL if out of memory)
+static CompressedGraph* cgraph_encode_begin(int num_vertices, GraphType type,
+                                            WeightType weight_type) {
+    CompressedGraph* cg = (CompressedGraph*)malloc(sizeof(CompressedGraph));
+    if (cg == NULL) return NULL;
+    cg->type = type;
+    cg->weight_type = weight_type;
+    cg->num_vertices = num_vertices;
+    cg->num_arcs = 0;
+    cg->num_edges = 0;
+    cg->data = NULL;
+    cg->data_size = 0;
+    cg->offsets = (uint64_t*)malloc((num_vertices + 1) * sizeof(uint64_t));
+    if (cg->offsets == NULL) {
+        free(cg);
+        return NULL;
+    }
+    return cg;
+}
+
+/**
+ * Append vertex u, whose arcs (sorted with compare_arcs) are arcs[0..n).
+ * Duplicate arcs are dropped, keeping the lightest weight.
+ */
+static void cgraph_encode_vertex(CompressedGraph* cg, ByteBuffer* buf, int u,
+                                 const Edge* arcs, long long n, long long* self_loops) {
+    cg->offsets[u] = buf->size;
+
+    // Count distinct neighbors of u
+    int degree = 0;
+    for (long long j = 0; j < n; j++) {
+        if (j == 0 || arcs[j].v != arcs[j - 1].v) degree++;
+    }
+
+    byte_buffer_varint(buf, degree);
+    int prev = u;
+    for (long long j = 0; j < n; j++) {
+        if (j > 0 && arcs[j].v == arcs[j - 1].v) continue;
+        if (j == 0) {
+            byte_buffer_varint(buf, zigzag_encode((int64_t)arcs[j].v - prev));
+        } else {
+            byte_buffer_varint(buf, (uint64_t)(arcs[j].v - prev));
+        }
+        if (cg->weight_type == WEIGHTED) {
+            byte_buffer_varint(buf, zigzag_encode(arcs[j].weight));
+        }
+        if (arcs[j].v == u) (*self_loops)++;   // Stored once even when UNDIRECTED
+        prev = arcs[j].v;
+    }
+    cg->num_arcs += degree;
+}
+
+// Close the offsets and trim the encode buffer to its final size
+static CompressedGraph* cgraph_encode_end(CompressedGraph* cg, ByteBuffer* buf,
+                                          long long self_loops) {
+    cg->offsets[cg->num_vertices] = buf->size;
+    cg->data = (uint8_t*)realloc(buf->bytes, buf->size > 0 ? buf->size : 1);
+    cg->data_size = buf->size;
+    cg->num_edges = (int)(cg->type == UNDIRECTED ? (cg->num_arcs - self_loops) / 2 + self_loops
+                                                 : cg->num_arcs);
+    return cg;
+}
+
+/**
+ * Encode arcs (sorted with compare_arcs) into a CompressedGraph.
+ * Duplicate arcs are dropped, keeping the lightest weight.
+ */
+static CompressedGraph* cgraph_encode_sorted(int num_vertices, GraphType type,
+                                             WeightType weight_type,
+                                             const Edge* arcs, long long num_arcs) {
+    CompressedGraph* cg = cgraph_encode_begin(num_vertices, type, weight_type);
+    if (cg == NULL) return NULL;
+    ByteBuffer buf = {NULL, 0, 0};
+    long long self_loops = 0;
+    long long i = 0;
+    for (int u = 0; u < num_vertices; u++) {
+        long long start = i;
+        while (i < num_arcs && arcs[i].u == u) i++;
+        cgraph_encode_vertex(cg, &buf, u, arcs + start, i - start, &self_loops);
+    }
+    return cgraph_encode_end(cg, &buf, self_loops);
+}
+
+/**
+ * Build a compressed graph from an edge list
+ *
+ * This is the path for graphs that are too big to ever exist as a
+ * Graph, so the arcs are never all materialized at once. Two passes:
+ *   1. count the arcs of each source vertex (both directions when
+ *      UNDIRECTED)
+ *   2. for each run of vertices whose arcs fit in one chunk of
+ *      CGRAPH_BUILD_CHUNK arcs: scan the edges, scatter that run's
+ *      arcs into per-vertex buckets, sort each bucket and encode it
+ * Peak build memory is the caller's edges, one count per vertex, one
+ * chunk (12 bytes/arc, 12 MB) and the output. The edges are scanned
+ * once per chunk.
+ *
+ * @return NULL if an endpoint is outside [0, num_vertices) or memory
+ *         runs out
+ *
+ * Time: O(E × chunks + E log d) where d is the max degree
+ */
+#define CGRAPH_BUILD_CHUNK (1 << 20)
+
+static CompressedGraph* cgraph_from_edges_chunked(int num_vertices, GraphType type,
+                                                  WeightType weight_type, const Edge* edges,
+                                                  long long num_edges, long long chunk_arcs) {
+    if (num_vertices < 0) return NULL;
+
+    // 1. Arcs per source vertex (and the largest, which must fit a chunk)
+    long long* count = (long long*)calloc(num_vertices + 1, sizeof(long long));
+    if (count == NULL) return NULL;
+    for (long long i = 0; i < num_edges; i++) {
+        int u = edges[i].u, v = edges[i].v;
+        if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
+            free(count);
+            return NULL;
+        }
+        count[u]++;
+        if (type == UNDIRECTED && u != v) count[v]++;
+    }
+    long long total = 0, max_degree = 0;
+    for (int u = 0; u < num_vertices; u++) {
+        total += count[u];
+        if (count[u] > max_degree) max_degree = count[u];
+    }
+    long long capacity = total < chunk_arcs ? total : chunk_arcs;
+    if (capacity < max_degree) capacity = max_degree;
+
+    CompressedGraph* cg = cgraph_encode_begin(num_vertices, type, weight_type);
+    Edge* chunk = (Edge*)malloc((capacity > 0 ? capacity : 1) * sizeof(Edge));
+    if (cg == NULL || chunk == NULL) {
+        if (cg) free(cg->offsets);
+        free(cg);
+        free(chunk);
+        free(count);
+        return NULL;
+    }
+
+    ByteBuffer buf = {NULL, 0, 0};
+    long long self_loops = 0;
+    int lo = 0;
+    while (lo < num_vertices) {
+        // 2. Vertices [lo, hi) fit in one chunk; count[u] becomes u's
+        //    bucket start, then (after the scatter) its end
+        int hi = lo;
+        long long used = 0;
+        while (hi < num_vertices && used + count[hi] <= capacity) {
+            long long c = count[hi];
+            count[hi++] = used;
+            used += c;
+        }
+
+        for (long long i = 0; i < num_edges; i++) {
+            Edge e = edges[i];
+            if (weight_type == UNWEIGHTED) e.weight = 1;
+            if (e.u >= lo && e.u < hi) chunk[count[e.u]++] = e;
+            if (type == UNDIRECTED && e.u != e.v && e.v >= lo && e.v < hi) {
+                Edge r = {e.v, e.u, e.weight};
+                chunk[count[e.v]++] = r;
+            }
+        }
+
+        for (int u = lo; u < hi; u++) {
+            long long start = u == lo ? 0 : count[u - 1];
+            qsort(chunk + start, count[u] - start, sizeof(Edge), compare_arcs);
+            cgraph_encode_vertex(cg, &buf, u, chunk + start, count[u] - start, &self_loops);
+        }
+        lo = hi;
+    }
+
+    free(chunk);
+    free(count);
+    return cgraph_encode_end(cg, &buf, self_loops);
+}
+
+CompressedGraph* cgraph_from_edges(int num_vertices, GraphType type, WeightType weight_type,
+                                   const Edge* edges, long long num_edges) {
+    return cgraph_from_edges_chunked(num_vertices, type, weight_type, edges, num_edges,
+                                     CGRAPH_BUILD_CHUNK);
+}
+
+/**
+ * Build a compressed graph from an existing Graph (either representation)
+ */
+CompressedGraph* cgraph_from_graph(Graph* graph) {
+    int V = graph->num_vertices;
+
+    // Count stored arcs
+    long long num_arcs = 0;
+    for (int u = 0; u < V; u++) {
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                num_arcs++;
+            }
+        } else {
+            for (int v = 0; v < V; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE) num_arcs++;
+            }
+        }
+    }
+
+    Edge* arcs = (Edge*)malloc((num_arcs > 0 ? num_arcs : 1) * sizeof(Edge));
+    long long k = 0;
+    for (int u = 0; u < V; u++) {
+        long long start = k;
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                Edge e = {u, node->dest, node->weight};
+                arcs[k++] = e;
+            }
+            // Lists are in insertion order - sort this vertex's slice
+            qsort(arcs + start, k - start, sizeof(Edge), compare_arcs);
+        } else {
+            for (int v = 0; v < V; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE) {
+                    Edge e = {u, v, graph->adj_matrix[u][v]};
+                    arcs[k++] = e;
+                }
+            }
+        }
+    }
+
+    CompressedGraph* cg = cgraph_encode_sorted(V, graph->type, graph->weight_type, arcs, k);
+    if (cg) cg->num_edges = graph->num_edges;
+
+    free(arcs);
+    return cg;
+}
+
+/**
+ * Total bytes used by the compressed representation
+ */
+size_t cgraph_memory_bytes(const CompressedGraph* cg) {
+    return sizeof(CompressedGraph) +
+           (cg->num_vertices + 1) * sizeof(uint64_t) +
+           cg->data_size;
+}
+
+void cgraph_destroy(CompressedGraph* cg) {
+    free(cg->offsets);
+    free(cg->data);
+    free(cg);
+}
+
+// ------------------------------------------------------------
+// Algorithms on the compressed graph
+// ------------------------------------------------------------
+
+/**
+ * BFS distances (in edges) from src
+ *
+ * @param distance  Output array of V entries (INF if unreachable)
+ * @return          Number of reachable vertices
+ */
+int cgraph_bfs(const CompressedGraph* cg, int src, int* distance) {
+    int V = cg->num_vertices;
+    int* queue = (int*)malloc(V * sizeof(int));
+    for (int i = 0; i < V; i++) {
+        distance[i] = INF;
+    }
+
+    int front = 0, rear = 0;
+    distance[src] = 0;
+    queue[rear++] = src;
+
+    while (front < rear) {
+        int u = queue[front++];
+        CGIterator it;
+        int v, w;
+        cgraph_iter_begin(cg, u, &it);
+        while (cgraph_iter_next(&it, &v, &w)) {
+            if (distance[v] == INF) {
+                distance[v] = distance[u] + 1;
+                queue[rear++] = v;
+            }
+        }
+    }
+
+    free(queue);
+    return rear;
+}
+
+/**
+ * Dijkstra distances from src (non-negative weights)
+ *
+ * Time: O((V+E) log V) with the lazy-deletion min-heap
+ *
+ * @param distance  Output array of V entries (INF if unreachable)
+ */
+void cgraph_dijkstra(const CompressedGraph* cg, int src, int* distance) {
+    int V = cg->num_vertices;
+    for (int i = 0; i < V; i++) {
+        distance[i] = INF;
+    }
+
+    MinHeap heap;
+    min_heap_init(&heap, V);
+    distance[src] = 0;
+    min_heap_push(&heap, src, 0);
+
+    while (heap.size > 0) {
+        HeapItem item = min_heap_pop(&heap);
+        int u = item.vertex;
+        if (item.dist > distance[u]) continue;  // Stale entry
+
+        CGIterator it;
+        int v, w;
+        cgraph_iter_begin(cg, u, &it);
+        while (cgraph_iter_next(&it, &v, &w)) {
+            int nd = distance[u] + w;
+            if (nd < distance[v]) {
+                distance[v] = nd;
+                min_heap_push(&heap, v, nd);
+            }
+        }
+    }
+
+    min_heap_free(&heap);
+}
+
+/**
+ * PageRank (power iteration, push style)
+ *
+ * PR(v) = (1-d)/V + d × ( Σ_{u→v} PR(u)/outdeg(u) + dangling/V )
+ *
+ * Each iteration is one sequential pass over the compressed stream.
+ * Mass from vertices with no out-edges (dangling) is spread uniformly.
+ *
+ * @param damping     Damping factor d (typically 0.85)
+ * @param max_iters   Iteration cap
+ * @param tolerance   Stop when L1 change < tolerance
+ * @param rank        Output array of V scores (sums to 1)
+ * @return            Iterations performed
+ */
+int cgraph_pagerank(const CompressedGraph* cg, double damping, int max_iters,
+                    double tolerance, double* rank) {
+    int V = cg->num_vertices;
+    if (V == 0) return 0;        // Nothing to rank
+    double* next = (double*)malloc(V * sizeof(double));
+    for (int i = 0; i < V; i++) {
+        rank[i] = 1.0 / V;
+    }
+
+    int iter = 0;
+    while (iter < max_iters) {
+        iter++;
+        double dangling = 0.0;
+        for (int i = 0; i < V; i++) {
+            next[i] = 0.0;
+        }
+
+        for (int u = 0; u < V; u++) {
+            CGIterator it;
+            int v, w;
+            cgraph_iter_begin(cg, u, &it);
+            if (it.remaining == 0) {
+                dangling += rank[u];
+                continue;
+            }
+            double share = rank[u] / it.remaining;
+            while (cgraph_iter_next(&it, &v, &w)) {
+                next[v] += share;
+            }
+        }
+
+        double base = (1.0 - damping) / V + damping * dangling / V;
+        double change = 0.0;
+        for (int i = 0; i < V; i++) {
+            double value = base + damping * next[i];
+            change += fabs(value - rank[i]);
+            rank[i] = value;
+        }
+
+        if (change < tolerance) break;
+    }
+
+    free(next);
+    return iter;
+}
+
+// ============================================================
+// BITSET ADJACENCY MATRIX - Unweighted graphs, word-parallel ops
+// ============================================================
+
+/**
+ * Packed Bitset Adjacency Matrix
+ *
+ * Why?
+ * ----
+ * ADJACENCY_MATRIX stores one int (32 bits) per cell in V separately
+ * allocated rows. For UNWEIGHTED graphs only 1 bit per cell carries
+ * information:
+ *
+ *   V = 50,000:  int matrix = 50k² × 4 B  = 10 GB
+ *                bitset     = 50k² / 8 B  = 312 MB
+ *
+ * Layout:
+ * -------
+ * Row u is words_per_row = ceil(V/64) uint64_t words, all rows in ONE
+ * contiguous allocation. Bit v of row u is set iff edge u→v exists:
+ *
+ *   row(u)[v / 64] & (1ULL << (v % 64))
+ *
+ * Word-parallel operations (64 vertices per instruction):
+ * -------------------------------------------------------
+ * - Common neighbors:  popcount(row(u) AND row(v))
+ * - BFS expansion:     next |= row(u) for every u in frontier,
+ *                      then next &= ~visited
+ * - Transitive closure (Warshall):
+ *                      if u reaches k: row(u) |= row(k)
+ *
+ * Time: BFS O(V²/64), closure O(V³/64), intersection O(V/64)
+ * Space: O(V²/8) bytes
+ */
+typedef struct {
+    GraphType type;
+    int num_vertices;
+    long long num_edges;         // Closures reach V² (2.5e9 at V = 50k)
+    int words_per_row;           // ceil(V / 64)
+    uint64_t* bits;              // V × words_per_row, row-major
+} BitMatrix;
+
+static inline uint64_t* bitmatrix_row(const BitMatrix* bm, int u) {
+    return bm->bits + (size_t)u * bm->words_per_row;
+}
+
+static inline bool bitset_test(const uint64_t* set, int i) {
+    return (set[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void bitset_set(uint64_t* set, int i) {
+    set[i >> 6] |= 1ULL << (i & 63);
+}
+
+BitMatrix* bitmatrix_create(int num_vertices, GraphType type) {
+    BitMatrix* bm = (BitMatrix*)malloc(sizeof(BitMatrix));
+    bm->type = type;
+    bm->num_vertices = num_vertices;
+    bm->num_edges = 0;
+    bm->words_per_row = (num_vertices + 63) / 64;
+    bm->bits = (uint64_t*)calloc((size_t)num_vertices * bm->words_per_row, sizeof(uint64_t));
+    return bm;
+}
+
+void bitmatrix_destroy(BitMatrix* bm) {
+    free(bm->bits);
+    free(bm);
+}
+
+bool bitmatrix_has_edge(const BitMatrix* bm, int src, int dest) {
+    return bitset_test(bitmatrix_row(bm, src), dest);
+}
+
+void bitmatrix_add_edge(BitMatrix* bm, int src, int dest) {
+    if (src < 0 || src >= bm->num_vertices || dest < 0 || dest >= bm->num_vertices) {
+        printf("Invalid vertex indices\n");
+        return;
+    }
+    if (bitmatrix_has_edge(bm, src, dest)) return;
+
+    bitset_set(bitmatrix_row(bm, src), dest);
+    bm->num_edges++;
+    if (bm->type == UNDIRECTED) {
+        bitset_set(bitmatrix_row(bm, dest), src);
+    }
+}
+
+/**
+ * Convert any Graph to a bitset matrix (weights are dropped)
+ */
+BitMatrix* bitmatrix_from_graph(Graph* graph) {
+    BitMatrix* bm = bitmatrix_create(graph->num_vertices, graph->type);
+
+    for (int u = 0; u < graph->num_vertices; u++) {
+        uint64_t* row = bitmatrix_row(bm, u);
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                bitset_set(row, node->dest);
+            }
+        } else {
+            for (int v = 0; v < graph->num_vertices; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE) bitset_set(row, v);
+            }
+        }
+    }
+    bm->num_edges = graph->num_edges;
+    return bm;
+}
+
+size_t bitmatrix_memory_bytes(const BitMatrix* bm) {
+    return sizeof(BitMatrix) +
+           (size_t)bm->num_vertices * bm->words_per_row * sizeof(uint64_t);
+}
+
+/**
+ * Number of out-neighbors shared by u and v
+ *
+ * popcount(row(u) AND row(v)) - 64 candidates per instruction
+ */
+int bitmatrix_common_neighbors(const BitMatrix* bm, int u, int v) {
+    const uint64_t* a = bitmatrix_row(bm, u);
+    const uint64_t* b = bitmatrix_row(bm, v);
+    int count = 0;
+    for (int i = 0; i < bm->words_per_row; i++) {
+        count += __builtin_popcountll(a[i] & b[i]);
+    }
+    return count;
+}
+
+/**
+ * popcount(a AND b) restricted to bit positions >= from
+ */
+static int bitset_and_count_from(const uint64_t* a, const uint64_t* b, int from, int W) {
+    int wi = from >> 6;
+    if (wi >= W) return 0;
+
+    int count = __builtin_popcountll(a[wi] & b[wi] & (~0ULL << (from & 63)));
+    for (int k = wi + 1; k < W; k++) {
+        count += __builtin_popcountll(a[k] & b[k]);
+    }
+    return count;
+}
+
+/**
+ * Count triangles in an UNDIRECTED graph
+ *
+ * For every edge (u,v) with u < v, count common neighbors w > v so each
+ * triangle u < v < w is counted exactly once.
+ *
+ * Time: O(E × V/64)
+ */
+long long bitmatrix_count_triangles(const BitMatrix* bm) {
+    long long triangles = 0;
+    int W = bm->words_per_row;
+
+    for (int u = 0; u < bm->num_vertices; u++) {
+        const uint64_t* ru = bitmatrix_row(bm, u);
+        int from = u + 1;
+
+        for (int wi = from >> 6; wi < W; wi++) {
+            uint64_t word = ru[wi];
+            if (wi == from >> 6) word &= ~0ULL << (from & 63);
+
+            while (word) {
+                int v = wi * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+                triangles += bitset_and_count_from(ru, bitmatrix_row(bm, v), v + 1, W);
+            }
+        }
+    }
+    return triangles;
+}
+
+/**
+ * Word-parallel BFS
+ *
+ * Frontier and visited sets are bitsets. Expanding a level ORs whole
+ * rows (64 neighbors per word op) instead of testing V matrix cells
+ * one at a time per frontier vertex.
+ *
+ * Time: O(V²/64)
+ *
+ * @param distance  Output array of V entries (INF if unreachable)
+ * @return          Number of reachable vertices
+ */
+int bitmatrix_bfs(const BitMatrix* bm, int src, int* distance) {
+    int V = bm->num_vertices;
+    int W = bm->words_per_row;
+    uint64_t* frontier = (uint64_t*)calloc(W, sizeof(uint64_t));
+    uint64_t* next = (uint64_t*)calloc(W, sizeof(uint64_t));
+    uint64_t* visited = (uint64_t*)calloc(W, sizeof(uint64_t));
+
+    for (int i = 0; i < V; i++) {
+        distance[i] = INF;
+    }
+
+    distance[src] = 0;
+    bitset_set(frontier, src);
+    bitset_set(visited, src);
+    int reached = 1;
+    int level = 0;
+    bool active = true;
+
+    while (active) {
+        level++;
+        memset(next, 0, W * sizeof(uint64_t));
+
+        // next = OR of rows of all frontier vertices
+        for (int wi = 0; wi < W; wi++) {
+            uint64_t word = frontier[wi];
+            while (word) {
+                int u = wi * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+                const uint64_t* row = bitmatrix_row(bm, u);
+                for (int k = 0; k < W; k++) {
+                    next[k] |= row[k];
+                }
+            }
+        }
+
+        // Drop already-visited vertices, record new ones
+        active = false;
+        for (int wi = 0; wi < W; wi++) {
+            uint64_t fresh = next[wi] & ~visited[wi];
+            frontier[wi] = fresh;
+            visited[wi] |= fresh;
+            if (fresh) active = true;
+            while (fresh) {
+                int v = wi * 64 + __builtin_ctzll(fresh);
+                fresh &= fresh - 1;
+                distance[v] = level;
+                reached++;
+            }
+        }
+    }
+
+    free(frontier);
+    free(next);
+    free(visited);
+    return reached;
+}
+
+/**
+ * Bit-parallel transitive closure (Warshall's algorithm)
+ *
+ * reach[i][j] = 1 iff there is a path of length >= 1 from i to j
+ *
+ * Warshall: for each k, every row that reaches k inherits row k:
+ *   if reach[i][k]: reach[i] |= reach[k]      (V/64 word ORs)
+ *
+ * Time: O(V³/64) instead of O(V³)
+ *
+ * @return  New BitMatrix holding the closure (caller destroys)
+ */
+BitMatrix* bitmatrix_transitive_closure(const BitMatrix* bm) {
+    int V = bm->num_vertices;
+    int W = bm->words_per_row;
+    BitMatrix* reach = bitmatrix_create(V, DIRECTED);
+    memcpy(reach->bits, bm->bits, (size_t)V * W * sizeof(uint64_t));
+
+    for (int k = 0; k < V; k++) {
+        const uint64_t* rk = bitmatrix_row(reach, k);
+        for (int i = 0; i < V; i++) {
+            uint64_t* ri = bitmatrix_row(reach, i);
+            if (!bitset_test(ri, k)) continue;
+            for (int w = 0; w < W; w++) {
+                ri[w] |= rk[w];
+            }
+        }
+    }
+
+    long long edges = 0;
+    for (size_t i = 0; i < (size_t)V * W; i++) {
+        edges += __builtin_popcountll(reach->bits[i]);
+    }
+    reach->num_edges = edges;
+    return reach;
+}
+
+// ============================================================
+// DYNAMIC GRAPH - Batched updates with incremental SSSP repair
+// ============================================================
+
+/**
+ * Dynamic Graph
+ *
+ * Adjacency is a growable ARRAY per vertex (not a linked list), so
+ * appending an edge is amortized O(1) and a vertex's edges stay
+ * contiguous. An EdgeIndex maps (src, dst) → position in src's array,
+ * so a weight decrease finds its edge in O(1).
+ *
+ * Supported updates (batched):
+ * - Insert a new edge
+ * - Decrease the weight of an existing edge
+ * (Weight increases / deletions would need a different repair strategy
+ *  and are ignored.)
+ */
+typedef struct {
+    int* dest;
+    int* weight;
+    int size;
+    int capacity;
+} DynAdjacency;
+
+typedef struct {
+    GraphType type;
+    int num_vertices;
+    int num_edges;
+    DynAdjacency* adj;           // Per-vertex edge arrays
+    EdgeIndex* position;         // (src, dst) → index in adj[src]
+} DynamicGraph;
+
+/**
+ * One update: insert src→dest, or lower its weight if it exists
+ */
+typedef struct {
+    int src;
+    int dest;
+    int weight;
+} EdgeUpdate;
+
+/**
+ * Single-source shortest path state kept alive between batches
+ */
+typedef struct {
+    int source;
+    int num_vertices;
+    int* distance;
+    int* parent;
+    MinHeap heap;                // Reused across repairs
+} SSSPState;
+
+DynamicGraph* dyn_graph_create(int num_vertices, GraphType type) {
+    DynamicGraph* dg = (DynamicGraph*)malloc(sizeof(DynamicGraph));
+    dg->type = type;
+    dg->num_vertices = num_vertices;
+    dg->num_edges = 0;
+    dg->adj = (DynAdjacency*)calloc(num_vertices, sizeof(DynAdjacency));
+    dg->position = edge_index_create(num_vertices);
+    return dg;
+}
+
+void dyn_graph_destroy(DynamicGraph* dg) {
+    for (int i = 0; i < dg->num_vertices; i++) {
+        free(dg->adj[i].dest);
+        free(dg->adj[i].weight);
+    }
+    free(dg->adj);
+    edge_index_destroy(dg->position);
+    free(dg);
+}
+
+static void dyn_adjacency_append(DynAdjacency* a, int dest, int weight) {
+    if (a->size == a->capacity) {
+        a->capacity = a->capacity == 0 ? 4 : 2 * a->capacity;
+        a->dest = (int*)realloc(a->dest, a->capacity * sizeof(int));
+        a->weight = (int*)realloc(a->weight, a->capacity * sizeof(int));
+    }
+    a->dest[a->size] = dest;
+    a->weight[a->size] = weight;
+    a->size++;
+}
+
+/**
+ * Apply one directed arc update
+ *
+ * @return true if the arc was inserted or its weight decreased
+ */
+static bool dyn_graph_apply_arc(DynamicGraph* dg, int src, int dest, int weight) {
+    int* pos = edge_index_find(dg->position, src, dest);
+    if (pos == NULL) {
+        edge_index_put(dg->position, src, dest, dg->adj[src].size);
+        dyn_adjacency_append(&dg->adj[src], dest, weight);
+        return true;
+    }
+
+    int* current = &dg->adj[src].weight[*pos];
+    if (weight < *current) {
+        *current = weight;
+        return true;
+    }
+    return false;  // Same or higher weight - ignored
+}
+
+/**
+ * Apply a batch of updates to the graph
+ *
+ * @param effective  Output: the updates that changed the graph
+ *                   (may alias updates for in-place filtering)
+ * @return           Number of effective updates
+ */
+int dyn_graph_apply_batch(DynamicGraph* dg, const EdgeUpdate* updates, int n,
+                          EdgeUpdate* effective) {
+    int count = 0;
+
+    for (int i = 0; i < n; i++) {
+        EdgeUpdate u = updates[i];
+        if (u.src < 0 || u.src >= dg->num_vertices ||
+            u.dest < 0 || u.dest >= dg->num_vertices || u.weight < 0) {
+            continue;
+        }
+
+        bool was_new = edge_index_find(dg->position, u.src, u.dest) == NULL;
+        bool changed = dyn_graph_apply_arc(dg, u.src, u.dest, u.weight);
+        if (dg->type == UNDIRECTED && u.src != u.dest) {
+            dyn_graph_apply_arc(dg, u.dest, u.src, u.weight);
+        }
+
+        if (changed) {
+            if (was_new) dg->num_edges++;
+            effective[count++] = u;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Build a dynamic graph from a Graph
+ */
+DynamicGraph* dyn_graph_from_graph(Graph* graph) {
+    DynamicGraph* dg = dyn_graph_create(graph->num_vertices, graph->type);
+
+    for (int u = 0; u < graph->num_vertices; u++) {
+        if (graph->representation == ADJACENCY_LIST) {
+            for (AdjListNode* node = graph->adj_list[u]; node != NULL; node = node->next) {
+                dyn_graph_apply_arc(dg, u, node->dest, node->weight);
+            }
+        } else {
+            for (int v = 0; v < graph->num_vertices; v++) {
+                if (graph->adj_matrix[u][v] != NO_EDGE) {
+                    dyn_graph_apply_arc(dg, u, v, graph->adj_matrix[u][v]);
+                }
+            }
+        }
+    }
+    dg->num_edges = graph->num_edges;
+    return dg;
+}
+
+/**
+ * Dijkstra main loop over whatever is currently in the heap
+ *
+ * @return Number of vertices whose distance improved
+ */
+static int sssp_settle(SSSPState* st, const DynamicGraph* dg) {
+    int improved = 0;
+
+    while (st->heap.size > 0) {
+        HeapItem item = min_heap_pop(&st->heap);
+        int u = item.vertex;
+        if (item.dist > st->distance[u]) continue;  // Stale entry
+
+        const DynAdjacency* a = &dg->adj[u];
+        for (int i = 0; i < a->size; i++) {
+            int v = a->dest[i];
+            int nd = st->distance[u] + a->weight[i];
+            if (nd < st->distance[v]) {
+                st->distance[v] = nd;
+                st->parent[v] = u;
+                min_heap_push(&st->heap, v, nd);
+                improved++;
+            }
+        }
+    }
+
+    return improved;
+}
+
+/**
+ * Compute shortest paths from source from scratch (Dijkstra)
+ */
+SSSPState* sssp_create(const DynamicGraph* dg, int source) {
+    SSSPState* st = (SSSPState*)malloc(sizeof(SSSPState));
+    st->source = source;
+    st->num_vertices = dg->num_vertices;
+    st->distance = (int*)malloc(dg->num_vertices * sizeof(int));
+    st->parent = (int*)malloc(dg->num_vertices * sizeof(int));
+    min_heap_init(&st->heap, dg->num_vertices);
+
+    for (int i = 0; i < dg->num_vertices; i++) {
+        st->distance[i] = INF;
+        st->parent[i] = -1;
+    }
+    st->distance[source] = 0;
+    min_heap_push(&st->heap, source, 0);
+    sssp_settle(st, dg);
+
+    return st;
+}
+
+void sssp_destroy(SSSPState* st) {
+    free(st->distance);
+    free(st->parent);
+    min_heap_free(&st->heap);
+    free(st);
+}
+
+/**
+ * Incremental repair after a batch of inserts / weight decreases
+ *
+ * Key fact: with non-negative weights, inserting an edge or lowering a
+ * weight can only make distances SMALLER. Every vertex whose distance
+ * improves is reachable through some changed edge (u,v) with
+ *   dist[u] + w(u,v) < dist[v]
+ *
+ * Algorithm:
+ * 1. Seed: for each effective update (u,v,w) that improves dist[v],
+ *    set dist[v] and push v on the heap (both directions if undirected)
+ * 2. Run the normal Dijkstra loop from the seeds only
+ *    → relaxation stops as soon as it reaches vertices whose distance
+ *      does not improve, so only the AFFECTED REGION is re-relaxed
+ *
+ * Time: O(affected × log affected + edges of affected vertices)
+ *       vs O((V+E) log V) for a full recomputation
+ *
+ * @return Number of distance improvements (size of affected region)
+ */
+int sssp_repair(SSSPState* st, const DynamicGraph* dg, const EdgeUpdate* effective, int m) {
+    st->heap.size = 0;
+    int improved = 0;
+
+    for (int i = 0; i < m; i++) {
+        for (int dir = 0; dir < (dg->type == UNDIRECTED ? 2 : 1); dir++) {
+            int u = dir == 0 ? effective[i].src : effective[i].dest;
+            int v = dir == 0 ? effective[i].dest : effective[i].src;
+
+            // Use the edge's current weight (a later update may have lowered it further)
+            int* pos = edge_index_find(dg->position, u, v);
+            int w = dg->adj[u].weight[*pos];
+
+            if (st->distance[u] != INF && st->distance[u] + w < st->distance[v]) {
+                st->distance[v] = st->distance[u] + w;
+                st->parent[v] = u;
+                min_heap_push(&st->heap, v, st->distance[v]);
+                improved++;
+            }
+        }
+    }
+
+    return improved + sssp_settle(st, dg);
+}
+
+// ============================================================
+// TYPED GRAPHS - Compile-time ID / weight widths (CSR)
+// ============================================================
+
+/**
+ * Typed CSR Graphs
+ *
+ * Graph/AdjListNode hard-code int IDs, int weights and int distances
+ * (INF = INT_MAX). DEFINE_TYPED_GRAPH generates a read-only CSR graph
+ * specialized for a chosen vertex-ID type, edge-weight type and
+ * distance type:
+ *
+ *   offsets[V+1]  (uint64_t)   targets[arcs] (ID_T)   weights[arcs] (WEIGHT_T)
+ *
+ * - Small graphs: uint32 IDs + int16 weights → 6 bytes per arc
+ *   (vs 16 bytes per AdjListNode)
+ * - Huge graphs / big path sums: uint64 IDs + int64 weights
+ *
+ * Relaxation is OVERFLOW-SAFE: dist + w saturates at DIST_INF instead
+ * of wrapping negative, so a sum too large for DIST_T reads as
+ * "unreachable" rather than a bogus short path. Pick DIST_T wider than
+ * WEIGHT_T (e.g. int16 weights → int32 distances) to make that rare.
+ *
+ * Generated API (S = suffix):
+ *   TypedGraph_S* tgraph_S_from_arcs(V, src[], dst[], w[], m, type)
+ *                 (NULL if an endpoint is >= V, or out of memory)
+ *   TypedGraph_S* tgraph_S_from_graph(Graph*)  (NULL if a weight doesn't fit)
+ *   void   tgraph_S_destroy(TypedGraph_S*)
+ *   size_t tgraph_S_memory_bytes(const TypedGraph_S*)
+ *   DIST_T tgraph_S_relax_sum(DIST_T d, WEIGHT_T w)
+ *   void   tgraph_S_dijkstra(const TypedGraph_S*, ID_T src, DIST_T* dist)
+ */
+
+// Range check done in double so one helper serves every WEIGHT_T
+static inline bool typed_weight_fits(int weight, double lo, double hi) {
+    return (double)weight >= lo && (double)weight <= hi;
+}
+
+#define DEFINE_TYPED_GRAPH(S, ID_T, WEIGHT_T, DIST_T, DIST_INF, WEIGHT_MIN, WEIGHT_MAX)      \
+                                                                                             \
+typedef struct {                                                                             \
+    ID_T num_vertices;                                                                       \
+    uint64_t num_arcs;                                                                       \
+    uint64_t* offsets;                  /* V+1 entries: arcs of u are [offsets[u], offsets[u+1]) */ \
+    ID_T* targets;                                                                           \
+    WEIGHT_T* weights;                                                                       \
+} TypedGraph_##S;                                                                            \
+                                                                                             \
+typedef struct {                                                                             \
+    DIST_T dist;                                                                             \
+    ID_T vertex;                                                                             \
+} TypedHeapItem_##S;                                                                         \
+                                                                                             \
+static inline DIST_T tgraph_##S##_relax_sum(DIST_T d, WEIGHT_T w) {                          \
+    if (d == (DIST_INF)) return (DIST_INF);                                                  \
+    if (w > 0 && d > (DIST_INF) - (DIST_T)w) return (DIST_INF);  /* Saturate */              \
+    return d + (DIST_T)w;                                                                    \
+}                                                                                            \
+                                                                                             \
+void tgraph_##S##_destroy(TypedGraph_##S* g) {                                               \
+    free(g->offsets);                                                                        \
+    free(g->targets);                                                                        \
+    free(g->weights);                                                                        \
+    free(g);                                                                                 \
+}                                                                                            \
+                                                                                             \
+TypedGraph_##S* tgraph_##S##_from_arcs(ID_T num_vertices, const ID_T* src, const ID_T* dst,  \
+                                       const WEIGHT_T* w, uint64_t m, GraphType type) {      \
+    /* Every endpoint must be a vertex: they index offsets below */                          \
+    for (uint64_t i = 0; i < m; i++) {                                                       \
+        if (src[i] >= num_vertices || dst[i] >= num_vertices) return NULL;                   \
+    }                                                                                        \
+    uint64_t arcs = type == UNDIRECTED ? 2 * m : m;                                          \
+    TypedGraph_##S* g = (TypedGraph_##S*)malloc(sizeof(TypedGraph_##S));                     \
+    uint64_t* fill = (uint64_t*)malloc(((size_t)num_vertices + 1) * sizeof(uint64_t));       \
+    if (g == NULL || fill == NULL) {                                                         \
+        free(g);                                                                             \
+        free(fill);                                                                          \
+        return NULL;                                                                         \
+    }                                                                                        \
+    g->num_vertices = num_vertices;                                                          \
+    g->num_arcs = arcs;                                                                      \
+    g->offsets = (uint64_t*)calloc((size_t)num_vertices + 1, sizeof(uint64_t));              \
+    g->targets = (ID_T*)malloc((arcs > 0 ? arcs : 1) * sizeof(ID_T));                        \
+    g->weights = (WEIGHT_T*)malloc((arcs > 0 ? arcs : 1) * sizeof(WEIGHT_T));                \
+    if (g->offsets == NULL || g->targets == NULL || g->weights == NULL) {                    \
+        tgraph_##S##_destroy(g);                                                             \
+        free(fill);                                                                          \
+        return NULL;                                                                         \
+    }                                                                                        \
+                                                                                             \
+    /* Counting sort by source: degree counts → prefix sums → scatter */                     \
+    for (uint64_t i = 0; i < m; i++) {                                                       \
+        g->offsets[src[i] + 1]++;                                                            \
+        if (type == UNDIRECTED) g->offsets[dst[i] + 1]++;                                    \
+    }                                                                                        \
+    for (ID_T u = 0; u < num_vertices; u++) {                                                \
+        g->offsets[u + 1] += g->offsets[u];                                                  \
+    }                                                                                        \
+    memcpy(fill, g->offsets, ((size_t)num_vertices + 1) * sizeof(uint64_t));                 \
+    for (uint64_t i = 0; i < m; i++) {                                                       \
+        uint64_t k = fill[src[i]]++;                                                         \
+        g->targets[k] = dst[i];                                                              \
+        g->weights[k] = w[i];                                                                \
+        if (type == UNDIRECTED) {                                                            \
+            k = fill[dst[i]]++;                                                              \
+            g->targets[k] = src[i];                                                          \
+            g->weights[k] = w[i];                                                            \
+        }                                                                                    \
+    }                                                                                        \
+    free(fill);                                                                              \
+    return g;                                                                                \
+}                                                                                            \
+                                                                                             \
+size_t tgraph_##S##_memory_bytes(const TypedGraph_##S* g) {                                  \
+    return sizeof(TypedGraph_##S) + ((size_t)g->num_vertices + 1) * sizeof(uint64_t) +       \
+           g->num_arcs * (sizeof(ID_T) + sizeof(WEIGHT_T));                                  \
+}                                                                                            \
+                                                                                             \
+TypedGraph_##S* tgraph_##S##_from_graph(Graph* graph) {                                      \
+    int V = graph->num_vertices;                                                             \
+    uint64_t m = 0;                                                                          \
+    for (int u = 0; u < V; u++) {                                                            \
+        if (graph->representation == ADJACENCY_LIST) {                                       \
+            for (AdjListNode* n = graph->adj_list[u]; n != NULL; n = n->next) m++;           \
+        } else {                                                                             \
+            for (int v = 0; v < V; v++) if (graph->adj_matrix[u][v] != NO_EDGE) m++;         \
+        }                                                                                    \
+    }                                                                                        \
+                                                                                             \
+    /* Stored arcs already include both directions of undirected edges */                   \
+    ID_T* src = (ID_T*)malloc((m > 0 ? m : 1) * sizeof(ID_T));                               \
+    ID_T* dst = (ID_T*)malloc((m > 0 ? m : 1) * sizeof(ID_T));                               \
+    WEIGHT_T* w = (WEIGHT_T*)malloc((m > 0 ? m : 1) * sizeof(WEIGHT_T));                     \
+    uint64_t k = 0;                                                                          \
+    bool fits = src && dst && w;                 /* false: out of memory */                  \
+    for (int u = 0; u < V && fits; u++) {                                                    \
+        if (graph->representation == ADJACENCY_LIST) {                                       \
+            for (AdjListNode* n = graph->adj_list[u]; n != NULL; n = n->next) {              \
+                if (!typed_weight_fits(n->weight, (WEIGHT_MIN), (WEIGHT_MAX))) { fits = false; break; } \
+                src[k] = (ID_T)u; dst[k] = (ID_T)n->dest; w[k] = (WEIGHT_T)n->weight; k++;  \
+            }                                                                                \
+        } else {                                                                             \
+            for (int v = 0; v < V; v++) {                                                    \
+                int wt = graph->adj_matrix[u][v];                                            \
+                if (wt == NO_EDGE) continue;                                                 \
+                if (!typed_weight_fits(wt, (WEIGHT_MIN), (WEIGHT_MAX))) { fits = false; break; } \
+                src[k] = (ID_T)u; dst[k] = (ID_T)v; w[k] = (WEIGHT_T)wt; k++;                \
+            }                                                                                \
+        }                                                                                    \
+    }                                                                                        \
+                                                                                             \
+    TypedGraph_##S* g = fits ? tgraph_##S##_from_arcs((ID_T)V, src, dst, w, k, DIRECTED) : NULL; \
+    free(src);                                                                               \
+    free(dst);                                                                               \
+    free(w);                                                                                 \
+    return g;                                                                                \
+}                                                                                            \
+                                                                                             \
+/* Dijkstra with a typed lazy-deletion binary heap; weights must be >= 0 */                  \
+void tgraph_##S##_dijkstra(const TypedGraph_##S* g, ID_T source, DIST_T* dist) {             \
+    size_t cap = (size_t)g->num_vertices + 16;                                               \
+    size_t size = 0;                                                                         \
+    TypedHeapItem_##S* heap = (TypedHeapItem_##S*)malloc(cap * sizeof(TypedHeapItem_##S));  \
+                                                                                             \
+    for (ID_T i = 0; i < g->num_vertices; i++) dist[i] = (DIST_INF);                         \
+    dist[source] = 0;                                                                        \
+    heap[size++] = (TypedHeapItem_##S){0, source};                                           \
+                                                                                             \
+    while (size > 0) {                                                                       \
+        TypedHeapItem_##S top = heap[0];                                                     \
+        TypedHeapItem_##S last = heap[--size];                                               \
+        size_t i = 0;                                                                        \
+        while (2 * i + 1 < size) {                                                           \
+            size_t c = 2 * i + 1;                                                            \
+            if (c + 1 < size && heap[c + 1].dist < heap[c].dist) c++;                        \
+            if (last.dist <= heap[c].dist) break;                                            \
+            heap[i] = heap[c];                                                               \
+            i = c;                                                                           \
+        }                                                                                    \
+        if (size > 0) heap[i] = last;                                                        \
+                                                                                             \
+        ID_T u = top.vertex;                                                                 \
+        if (top.dist > dist[u]) continue;  /* Stale entry */                                 \
+                                                                                             \
+        for (uint64_t e = g->offsets[u]; e < g->offsets[u + 1]; e++) {                       \
+            ID_T v = g->targets[e];                                                          \
+            DIST_T nd = tgraph_##S##_relax_sum(dist[u], g->weights[e]);                      \
+            if (nd >= dist[v]) continue;                                                     \
+            dist[v] = nd;                                                                    \
+                                                                                             \
+            if (size == cap) {                                                               \
+                cap *= 2;                                                                    \
+                heap = (TypedHeapItem_##S*)realloc(heap, cap * sizeof(TypedHeapItem_##S));  \
+            }                                                                                \
+            size_t j = size++;                                                               \
+            while (j > 0 && heap[(j - 1) / 2].dist > nd) {                                   \
+                heap[j] = heap[(j - 1) / 2];                                                 \
+                j = (j - 1) / 2;                                                             \
+            }                                                                                \
+            heap[j] = (TypedHeapItem_##S){nd, v};                                            \
+        }                                                                                    \
+    }                                                                                        \
+                                                                                             \
+    free(heap);                                                                              \
+}
+
+// Standard specializations
+//         suffix   ID type   weight   distance  DIST_INF    weight range
+DEFINE_TYPED_GRAPH(u32w16, uint32_t, int16_t, int32_t, INT32_MAX, INT16_MIN, INT16_MAX)
+DEFINE_TYPED_GRAPH(u32w32, uint32_t, int32_t, int64_t, INT64_MAX, INT32_MIN, INT32_MAX)
+DEFINE_TYPED_GRAPH(u64w64, uint64_t, int64_t, int64_t, INT64_MAX, INT64_MIN, INT64_MAX)
+DEFINE_TYPED_GRAPH(u32f32, uint32_t, float, double, INFINITY, -FLT_MAX, FLT_MAX)
+
+// ============================================================
+// DISTRIBUTED GRAPHS - 1D partitioning, pluggable transport
+// ============================================================
+
+/**
+ * 1D (edge-cut) partitioning
+ *
+ * Vertices are split into P contiguous ranges; part p OWNS
+ * [start[p], start[p+1]) together with all of their out-arcs.
+ * Range boundaries are chosen so every part stores about the same
+ * number of arcs (+1 per vertex), not the same number of vertices,
+ * so one high-degree region doesn't overload a single process.
+ *
+ * Arcs whose target lives in another part are CUT arcs: traversing
+ * one costs a message instead of a memory access.
+ *
+ * Owner lookup: binary search over start[] - O(log P)
+ */
+typedef struct {
+    int num_parts;
+    int num_vertices;
+    int* start;                  // P+1 entries
+    long long* arcs;             // Arcs stored by each part
+    long long cut_arcs;          // Arcs crossing parts
+    long long total_arcs;
+} GraphPartition;
+
+static inline int partition_owner(const GraphPartition* part, int v) {
+    int lo = 0, hi = part->num_parts - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (part->start[mid] <= v) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+/**
+ * Visit every stored arc u→v of a graph (matrix or list)
+ */
+#define FOR_EACH_ARC(graph, u, v, w, body)                                   \
+    do {                                                                     \
+        if ((graph)->representation == ADJACENCY_LIST) {                     \
+            for (AdjListNode* n_ = (graph)->adj_list[u]; n_; n_ = n_->next) { \
+                int v = n_->dest, w = n_->weight;                            \
+                body                                                         \
+            }                                                                \
+        } else {                                                             \
+            for (int v = 0; v < (graph)->num_vertices; v++) {                \
+                int w = (graph)->adj_matrix[u][v];                           \
+                if (w == NO_EDGE) continue;                                  \
+                body                                                         \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+GraphPartition* graph_partition_1d(Graph* graph, int num_parts) {
+    int V = graph->num_vertices;
+    if (num_parts < 1) num_parts = 1;
+
+    long long* degree = (long long*)calloc(V, sizeof(long long));
+    long long total = 0;
+    for (int u = 0; u < V; u++) {
+        FOR_EACH_ARC(graph, u, v, w, { (void)v; (void)w; degree[u]++; });
+        total += degree[u];
+    }
+
+    GraphPartition* part = (GraphPartition*)malloc(sizeof(GraphPartition));
+    part->num_parts = num_parts;
+    part->num_vertices = V;
+    part->start = (int*)malloc((num_parts + 1) * sizeof(int));
+    part->arcs = (long long*)calloc(num_parts, sizeof(long long));
+    part->total_arcs = total;
+
+    // Cut the prefix sum of (degree + 1) into equal slices
+    long long work_total = total + V;
+    long long prefix = 0;
+    int p = 0;
+    part->start[0] = 0;
+    for (int u = 0; u < V; u++) {
+        long long boundary = work_total * (p + 1) / num_parts;
+        if (p + 1 < num_parts && prefix >= boundary) {
+            part->start[++p] = u;
+        }
+        prefix += degree[u] + 1;
+    }
+    while (p < num_parts) part->start[++p] = V;
+
+    part->cut_arcs = 0;
+    for (int u = 0; u < V; u++) {
+        int pu = partition_owner(part, u);
+        part->arcs[pu] += degree[u];
+        FOR_EACH_ARC(graph, u, v, w, {
+            (void)w;
+            if (partition_owner(part, v) != pu) part->cut_arcs++;
+        });
+    }
+
+    free(degree);
+    return part;
+}
+
+void graph_partition_destroy(GraphPartition* part) {
+    free(part->start);
+    free(part->arcs);
+    free(part);
+}
+
+void graph_partition_print(const GraphPartition* part) {
+    printf("Partition: %d parts, %lld arcs, %lld cut (%.1f%%)\n",
+           part->num_parts, part->total_arcs, part->cut_arcs,
+           part->total_arcs > 0 ? 100.0 * part->cut_arcs / part->total_arcs : 0.0);
+    for (int p = 0; p < part->num_parts; p++) {
+        printf("  part %d: vertices [%d, %d)  arcs %lld\n",
+               p, part->start[p], part->start[p + 1], part->arcs[p]);
+    }
+}
+
+/**
+ * One rank's share of the graph: CSR over owned vertices,
+ * targets kept as GLOBAL vertex IDs
+ */
+typedef struct {
+    int rank;
+    int first;                   // First owned global vertex
+    int count;                   // Number of owned vertices
+    long long* offsets;          // count+1 entries
+    int* targets;
+    int* weights;
+} LocalGraph;
+
+LocalGraph* local_graph_extract(Graph* graph, const GraphPartition* part, int rank) {
+    LocalGraph* lg = (LocalGraph*)malloc(sizeof(LocalGraph));
+    lg->rank = rank;
+    lg->first = part->start[rank];
+    lg->count = part->start[rank + 1] - lg->first;
+    lg->offsets = (long long*)malloc((lg->count + 1) * sizeof(long long));
+    lg->targets = (int*)malloc((part->arcs[rank] > 0 ? part->arcs[rank] : 1) * sizeof(int));
+    lg->weights = (int*)malloc((part->arcs[rank] > 0 ? part->arcs[rank] : 1) * sizeof(int));
+
+    long long k = 0;
+    for (int i = 0; i < lg->count; i++) {
+        lg->offsets[i] = k;
+        FOR_EACH_ARC(graph, lg->first + i, v, w, {
+            lg->targets[k] = v;
+            lg->weights[k] = w;
+            k++;
+        });
+    }
+    lg->offsets[lg->count] = k;
+    return lg;
+}
+
+void local_graph_destroy(LocalGraph* lg) {
+    free(lg->offsets);
+    free(lg->targets);
+    free(lg->weights);
+    free(lg);
+}
+
+// ------------------------------------------------------------
+// Transport
+// ------------------------------------------------------------
+
+/**
+ * Pluggable message transport
+ *
+ * The distributed algorithms only ever call alltoall(): rank r hands
+ * over one buffer per destination rank and gets back one buffer per
+ * source rank. A transport for another fabric (TCP, MPI, RDMA) only has
+ * to implement this one collective.
+ *
+ * alltoall contract:
+ * - send_bufs[p] / send_sizes[p]: bytes for rank p (own slot is copied)
+ * - recv_bufs[p] / recv_sizes[p]: malloc'd bytes from rank p (caller frees)
+ * - returns 0 on success, -1 on failure
+ */
+typedef struct Transport Transport;
+
+struct Transport {
+    int rank;
+    int size;
+    int (*alltoall)(Transport* t, uint8_t* const* send_bufs, const size_t* send_sizes,
+                    uint8_t** recv_bufs, size_t* recv_sizes);
+    void (*close)(Transport* t);
+    void* impl;
+    long long bytes_sent;        // Statistics
+};
+
+/**
+ * Unix-domain socket transport: one SOCK_STREAM socketpair per pair
+ * of ranks, exchanged with non-blocking I/O under poll() so large
+ * all-to-all rounds can't deadlock on full socket buffers.
+ */
+typedef struct {
+    int* fds;                    // fds[peer], -1 for self
+} SocketTransport;
+
+typedef struct {
+    uint64_t header;             // Payload length (out) / received length (in)
+    size_t done;                 // Bytes transferred including 8-byte header
+    uint8_t* payload;
+} SocketStream;
+
+static int socket_alltoall(Transport* t, uint8_t* const* send_bufs, const size_t* send_sizes,
+                           uint8_t** recv_bufs, size_t* recv_sizes) {
+    SocketTransport* st = (SocketTransport*)t->impl;
+    int P = t->size;
+    SocketStream* out = (SocketStream*)calloc(P, sizeof(SocketStream));
+    SocketStream* in = (SocketStream*)calloc(P, sizeof(SocketStream));
+    struct pollfd* pfds = (struct pollfd*)malloc(P * sizeof(struct pollfd));
+    int* peer_of = (int*)malloc(P * sizeof(int));
+
+    // Own slot never touches the wire
+    recv_sizes[t->rank] = send_sizes[t->rank];
+    recv_bufs[t->rank] = (uint8_t*)malloc(send_sizes[t->rank] > 0 ? send_sizes[t->rank] : 1);
+    if (send_sizes[t->rank] > 0) {
+        memcpy(recv_bufs[t->rank], send_bufs[t->rank], send_sizes[t->rank]);
+    }
+
+    int pending = 0;
+    for (int p = 0; p < P; p++) {
+        if (p == t->rank) continue;
+        out[p].header = send_sizes[p];
+        out[p].payload = send_bufs[p];
+        pending += 2;            // One send and one receive per peer
+        t->bytes_sent += 8 + send_sizes[p];
+    }
+
+    int status = 0;
+    while (pending > 0 && status == 0) {
+        int n = 0;
+        for (int p = 0; p < P; p++) {
+            if (p == t->rank) continue;
+            short events = 0;
+            if (out[p].done < 8 + out[p].header) events |= POLLOUT;
+            if (in[p].done < 8 || in[p].done < 8 + in[p].header) events |= POLLIN;
+            if (events == 0) continue;
+            pfds[n].fd = st->fds[p];
+            pfds[n].events = events;
+            pfds[n].revents = 0;
+            peer_of[n++] = p;
+        }
+
+        if (poll(pfds, n, -1) < 0) {
+            if (errno == EINTR) continue;
+            status = -1;
+            break;
+        }
+
+        for (int i = 0; i < n && status == 0; i++) {
+            int p = peer_of[i];
+            int fd = pfds[i].fd;
+
+            if (pfds[i].revents & POLLOUT) {
+                SocketStream* s = &out[p];
+                const uint8_t* src = s->done < 8 ? (const uint8_t*)&s->header + s->done
+                                                 : s->payload + (s->done - 8);
+                size_t len = s->done < 8 ? 8 - s->done : s->header - (s->done - 8);
+                ssize_t w = write(fd, src, len);
+                if (w > 0) {
+                    s->done += (size_t)w;
+                    if (s->done == 8 + s->header) pending--;
+                } else if (w < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    status = -1;
+                }
+            }
+
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                SocketStream* s = &in[p];
+                uint8_t* dst;
+                size_t len;
+                if (s->done < 8) {
+                    dst = (uint8_t*)&s->header + s->done;
+                    len = 8 - s->done;
+                } else {
+                    dst = s->payload + (s->done - 8);
+                    len = s->header - (s->done - 8);
+                }
+                ssize_t r = len > 0 ? read(fd, dst, len) : 0;
+                if (r > 0) {
+                    s->done += (size_t)r;
+                } else if (r == 0 && len > 0) {
+                    status = -1;         // Peer closed mid-exchange
+                } else if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    status = -1;
+                }
+
+                if (s->done == 8 && s->payload == NULL) {
+                    s->payload = (uint8_t*)malloc(s->header > 0 ? s->header : 1);
+                }
+                if (s->done >= 8 && s->done == 8 + s->header) {
+                    recv_bufs[p] = s->payload;
+                    recv_sizes[p] = s->header;
+                    pending--;
+                }
+            }
+        }
+    }
+
+    // On failure the caller owns nothing: drop partial and complete receives
+    if (status != 0) {
+        for (int p = 0; p < P; p++) {
+            if (p == t->rank) continue;
+            free(in[p].payload);
+            recv_bufs[p] = NULL;
+            recv_sizes[p] = 0;
+        }
+        free(recv_bufs[t->rank]);
+        recv_bufs[t->rank] = NULL;
+        recv_sizes[t->rank] = 0;
+    }
+
+    free(out);
+    free(in);
+    free(pfds);
+    free(peer_of);
+    return status;
+}
+
+static void socket_close(Transport* t) {
+    SocketTransport* st = (SocketTransport*)t->impl;
+    for (int p = 0; p < t->size; p++) {
+        if (st->fds[p] >= 0) close(st->fds[p]);
+    }
+    free(st->fds);
+    free(st);
+}
+
+// Collectives built on alltoall
+
+/**
+ * Sum value over all ranks; every rank gets the total in *sum
+ *
+ * @return 0 on success, -1 on transport failure (*sum untouched)
+ */
+int dist_allreduce_sum(Transport* t, long long value, long long* sum) {
+    int P = t->size;
+    uint8_t** send = (uint8_t**)calloc(P, sizeof(uint8_t*));
+    uint8_t** recv = (uint8_t**)calloc(P, sizeof(uint8_t*));
+    size_t* send_sizes = (size_t*)calloc(P, sizeof(size_t));
+    size_t* recv_sizes = (size_t*)calloc(P, sizeof(size_t));
+    for (int p = 0; p < P; p++) {
+        send[p] = (uint8_t*)&value;
+        send_sizes[p] = sizeof(value);
+    }
+
+    int status = t->alltoall(t, send, send_sizes, recv, recv_sizes);
+    if (status == 0) {
+        long long total = 0;
+        for (int p = 0; p < P; p++) {
+            long long x;
+            memcpy(&x, recv[p], sizeof(x));
+            total += x;
+            free(recv[p]);
+        }
+        *sum = total;
+    }
+
+    free(send);
+    free(recv);
+    free(send_sizes);
+    free(recv_sizes);
+    return status;
+}
+
+/**
+ * Exchange per-destination ByteBuffers; replaces out[] contents with
+ * what each rank received (out[p] = bytes from rank p)
+ */
+static int dist_exchange(Transport* t, ByteBuffer* out) {
+    int P = t->size;
+    uint8_t** send = (uint8_t**)calloc(P, sizeof(uint8_t*));
+    uint8_t** recv = (uint8_t**)calloc(P, sizeof(uint8_t*));
+    size_t* send_sizes = (size_t*)calloc(P, sizeof(size_t));
+    size_t* recv_sizes = (size_t*)calloc(P, sizeof(size_t));
+    for (int p = 0; p < P; p++) {
+        send[p] = out[p].bytes;
+        send_sizes[p] = out[p].size;
+    }
+
+    int status = t->alltoall(t, send, send_sizes, recv, recv_sizes);
+    for (int p = 0; p < P; p++) {
+        free(out[p].bytes);
+        out[p].bytes = status == 0 ? recv[p] : NULL;
+        out[p].size = status == 0 ? recv_sizes[p] : 0;
+        out[p].capacity = out[p].size;
+    }
+
+    free(send);
+    free(recv);
+    free(send_sizes);
+    free(recv_sizes);
+    return status;
+}
+
+/**
+ * Collect each rank's owned slice into result[V] on rank 0
+ */
+static int dist_gather(Transport* t, const GraphPartition* part, const int* local, int* result) {
+    ByteBuffer* bufs = (ByteBuffer*)calloc(t->size, sizeof(ByteBuffer));
+    int count = part->start[t->rank + 1] - part->start[t->rank];
+    bufs[0].bytes = (uint8_t*)malloc(count * sizeof(int) + 1);
+    memcpy(bufs[0].bytes, local, count * sizeof(int));
+    bufs[0].size = count * sizeof(int);
+
+    int status = dist_exchange(t, bufs);
+    if (status == 0 && t->rank == 0) {
+        for (int p = 0; p < t->size; p++) {
+            memcpy(result + part->start[p], bufs[p].bytes, bufs[p].size);
+        }
+    }
+
+    for (int p = 0; p < t->size; p++) free(bufs[p].bytes);
+    free(bufs);
+    return status;
+}
+
+// ------------------------------------------------------------
+// Distributed algorithms
+// ------------------------------------------------------------
+
+/**
+ * Distributed level-synchronous BFS
+ *
+ * Each round (one BFS level):
+ * 1. Expand the local frontier; local targets are labeled directly,
+ *    remote targets are batched per owner (varint-encoded)
+ * 2. alltoall the batches; label unvisited received vertices
+ * 3. allreduce the next frontier size - stop when it is 0 everywhere
+ *
+ * @param result  Rank 0 only: V entries of BFS level (INF if unreachable)
+ * @return        Deepest level reached, or -1 on transport failure
+ */
+int dist_bfs(Transport* t, const GraphPartition* part, const LocalGraph* lg,
+             int source, int* result) {
+    int P = t->size;
+    int* level = (int*)malloc((lg->count > 0 ? lg->count : 1) * sizeof(int));
+    int* frontier = (int*)malloc((lg->count > 0 ? lg->count : 1) * sizeof(int));
+    int* next = (int*)malloc((lg->count > 0 ? lg->count : 1) * sizeof(int));
+    int frontier_size = 0;
+    ByteBuffer* bufs = (ByteBuffer*)calloc(P, sizeof(ByteBuffer));
+
+    for (int i = 0; i < lg->count; i++) level[i] = INF;
+    if (partition_owner(part, source) == t->rank) {
+        level[source - lg->first] = 0;
+        frontier[frontier_size++] = source - lg->first;
+    }
+
+    int depth = 0;
+    int status = 0;
+    while (1) {
+        int next_size = 0;
+
+        for (int f = 0; f < frontier_size; f++) {
+            int i = frontier[f];
+            for (long long e = lg->offsets[i]; e < lg->offsets[i + 1]; e++) {
+                int v = lg->targets[e];
+                int owner = partition_owner(part, v);
+                if (owner == t->rank) {
+                    if (level[v - lg->first] == INF) {
+                        level[v - lg->first] = depth + 1;
+                        next[next_size++] = v - lg->first;
+                    }
+                } else {
+                    byte_buffer_varint(&bufs[owner], (uint64_t)v);
+                }
+            }
+        }
+
+        if ((status = dist_exchange(t, bufs)) != 0) break;
+        for (int p = 0; p < P; p++) {
+            const uint8_t* q = bufs[p].bytes;
+            const uint8_t* end = q + bufs[p].size;
+            while (q < end) {
+                int i = (int)varint_decode(&q) - lg->first;
+                if (level[i] == INF) {
+                    level[i] = depth + 1;
+                    next[next_size++] = i;
+                }
+            }
+            free(bufs[p].bytes);
+            bufs[p].bytes = NULL;
+            bufs[p].size = bufs[p].capacity = 0;
+        }
+
+        int* tmp = frontier;
+        frontier = next;
+        next = tmp;
+        frontier_size = next_size;
+
+        long long total_next;
+        if ((status = dist_allreduce_sum(t, next_size, &total_next)) != 0) break;
+        if (total_next == 0) break;
+        depth++;
+    }
+
+    if (status == 0) status = dist_gather(t, part, level, result);
+
+    free(level);
+    free(frontier);
+    free(next);
+    free(bufs);
+    return status == 0 ? depth : -1;
+}
+
+/**
+ * Distributed SSSP (Bellman-Ford style, active-set relaxation)
+ *
+ * Only vertices whose distance improved in the previous round are
+ * relaxed. Remote relaxations travel as (vertex, candidate distance)
+ * varint pairs; the receiver keeps the minimum. Terminates when no rank
+ * improved anything - at most V-1 rounds, usually far fewer.
+ *
+ * Requires non-negative weights (negative cycles never terminate).
+ *
+ * @param result  Rank 0 only: V entries of distance (INF if unreachable)
+ * @return        Number of rounds, or -1 on transport failure
+ */
+int dist_sssp(Transport* t, const GraphPartition* part, const LocalGraph* lg,
+              int source, int* result) {
+    int P = t->size;
+    int n = lg->count > 0 ? lg->count : 1;
+    int* dist = (int*)malloc(n * sizeof(int));
+    bool* in_next = (bool*)calloc(n, sizeof(bool));
+    int* active = (int*)malloc(n * sizeof(int));
+    int* next = (int*)malloc(n * sizeof(int));
+    int active_size = 0;
+    ByteBuffer* bufs = (ByteBuffer*)calloc(P, sizeof(ByteBuffer));
+
+    for (int i = 0; i < lg->count; i++) dist[i] = INF;
+    if (partition_owner(part, source) == t->rank) {
+        dist[source - lg->first] = 0;
+        active[active_size++] = source - lg->first;
+    }
+
+    int rounds = 0;
+    int status = 0;
+    while (1) {
+        int next_size = 0;
+
+        for (int a = 0; a < active_size; a++) {
+            int i = active[a];
+            for (long long e = lg->offsets[i]; e < lg->offsets[i + 1]; e++) {
+                int v = lg->targets[e];
+                // Saturate: a sum at or past INF is no path, not a wrapped distance
+                long long sum = (long long)dist[i] + lg->weights[e];
+                if (sum >= INF) continue;
+                int nd = (int)sum;
+                int owner = partition_owner(part, v);
+                if (owner == t->rank) {
+                    int j = v - lg->first;
+                    if (nd < dist[j]) {
+                        dist[j] = nd;
+                        if (!in_next[j]) {
+                            in_next[j] = true;
+                            next[next_size++] = j;
+                        }
+                    }
+                } else {
+                    byte_buffer_varint(&bufs[owner], (uint64_t)v);
+                    byte_buffer_varint(&bufs[owner], (uint64_t)nd);
+                }
+            }
+        }
+
+        if ((status = dist_exchange(t, bufs)) != 0) break;
+        for (int p = 0; p < P; p++) {
+            const uint8_t* q = bufs[p].bytes;
+            const uint8_t* end = q + bufs[p].size;
+            while (q < end) {
+                int j = (int)varint_decode(&q) - lg->first;
+                int nd = (int)varint_decode(&q);
+                if (nd < dist[j]) {
+                    dist[j] = nd;
+                    if (!in_next[j]) {
+                        in_next[j] = true;
+                        next[next_size++] = j;
+                    }
+                }
+            }
+            free(bufs[p].bytes);
+            bufs[p].bytes = NULL;
+            bufs[p].size = bufs[p].capacity = 0;
+        }
+
+        for (int a = 0; a < next_size; a++) in_next[next[a]] = false;
+        int* tmp = active;
+        active = next;
+        next = tmp;
+        active_size = next_size;
+        rounds++;
+
+        long long total_next;
+        if ((status = dist_allreduce_sum(t, next_size, &total_next)) != 0) break;
+        if (total_next == 0) break;
+    }
+
+    if (status == 0) status = dist_gather(t, part, dist, result);
+
+    free(dist);
+    free(in_next);
+    free(active);
+    free(next);
+    free(bufs);
+    return status == 0 ? rounds : -1;
+}
+
+// ------------------------------------------------------------
+// Local launcher
+// ------------------------------------------------------------
+
+/**
+ * Per-rank entry point
+ *
+ * @return 0 on success, nonzero on failure (a child's exit status)
+ */
+typedef int (*DistributedMain)(Transport* t, void* arg);
+
+/**
+ * Run fn on num_ranks processes connected by a socket mesh
+ *
+ * Rank 0 runs in the calling process (so its results land in the
+ * caller's memory); ranks 1..P-1 are forked children that exit with
+ * fn's status. The graph is shared copy-on-write, standing in for each
+ * machine loading its own partition.
+ *
+ * If a fork fails, the children already started are killed and reaped
+ * and nothing runs.
+ *
+ * @return 0 if fn succeeded on every rank, -1 otherwise
+ */
+int dist_run_local(int num_ranks, DistributedMain fn, void* arg) {
+    int P = num_ranks;
+    int* fds = (int*)malloc(P * P * sizeof(int));  // fds[r*P + p]: rank r's end to p
+    for (int i = 0; i < P * P; i++) fds[i] = -1;
+
+    for (int r = 0; r < P; r++) {
+        for (int p = r + 1; p < P; p++) {
+            int sv[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+                perror("socketpair");
+                for (int i = 0; i < P * P; i++) if (fds[i] >= 0) close(fds[i]);
+                free(fds);
+                return -1;
+            }
+            fcntl(sv[0], F_SETFL, O_NONBLOCK);
+            fcntl(sv[1], F_SETFL, O_NONBLOCK);
+            fds[r * P + p] = sv[0];
+            fds[p * P + r] = sv[1];
+        }
+    }
+
+    fflush(NULL);                // Children must not inherit unflushed output
+    pid_t* pids = (pid_t*)malloc(P * sizeof(pid_t));
+    int my_rank = 0;
+    for (int r = 1; r < P; r++) {
+        pids[r] = fork();
+        if (pids[r] < 0) {
+            perror("fork");
+            for (int c = 1; c < r; c++) {
+                kill(pids[c], SIGKILL);
+                waitpid(pids[c], NULL, 0);
+            }
+            for (int i = 0; i < P * P; i++) if (fds[i] >= 0) close(fds[i]);
+            free(fds);
+            free(pids);
+            return -1;
+        }
+        if (pids[r] == 0) {
+            my_rank = r;
+            break;
+        }
+    }
+
+    // Keep only this rank's row of the mesh
+    for (int r = 0; r < P; r++) {
+        if (r == my_rank) continue;
+        for (int p = 0; p < P; p++) {
+            if (fds[r * P + p] >= 0) close(fds[r * P + p]);
+        }
+    }
+
+    SocketTransport* st = (SocketTransport*)malloc(sizeof(SocketTransport));
+    st->fds = (int*)malloc(P * sizeof(int));
+    memcpy(st->fds, fds + my_rank * P, P * sizeof(int));
+    Transport t = {my_rank, P, socket_alltoall, socket_close, st, 0};
+
+    int status = fn(&t, arg);
+    t.close(&t);
+    free(fds);
+
+    if (my_rank != 0) {
+        fflush(NULL);            // _exit skips stdio: keep what fn printed
+        _exit(status == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    int failures = status != 0;
+    for (int r = 1; r < P; r++) {
+        int wstatus;
+        if (waitpid(pids[r], &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
+            failures++;
+        }
+    }
+    free(pids);
+    return failures == 0 ? 0 : -1;
+}
+
+// ============================================================
+// QUERY ENGINE - Batched point-to-point shortest paths
+// ============================================================
+
+/**
+ * Query Engine
+ *
+ * graph_dijkstra()/graph_bfs_shortest_path() allocate and initialize
+ * O(V) arrays on every call - for a short query that reaches a few
+ * hundred vertices, the malloc + O(V) clear dominates.
+ *
+ * The engine instead:
+ * - Snapshots the graph into a read-only CSR once
+ * - Keeps a PERSISTENT thread pool; each worker owns scratch arrays
+ *   (dist, parent, queue, heap) sized to V, allocated once
+ * - Resets "visited" in O(1) with GENERATION STAMPS:
+ *     stamp[v] == generation  →  dist[v]/parent[v] are valid
+ *     anything else           →  v is unvisited this query
+ *   Each query just increments generation (full clear only on wrap)
+ * - Stops each search as soon as dst is settled (early exit)
+ *
+ * Per-query cost: O(vertices touched), not O(V)
+ */
+typedef enum {
+    QUERY_BFS,                   // Hop count (ignores weights)
+    QUERY_DIJKSTRA               // Weighted, non-negative weights
+} QueryMode;
+
+typedef struct {
+    int src;
+    int dst;
+    int distance;                // Output: INF if unreachable
+    int hops;                    // Output: edges on the returned path (-1 if none)
+} PathQuery;
+
+typedef struct {
+    int* dist;
+    int* parent;
+    unsigned* stamp;
+    unsigned generation;
+    int* queue;                  // BFS FIFO
+    MinHeap heap;                // Dijkstra
+    long long touched;           // Statistics: vertices labeled
+} QueryScratch;
+
+typedef struct QueryEngine QueryEngine;
+
+typedef struct {
+    QueryEngine* engine;
+    QueryScratch scratch;
+} QueryWorker;
+
+struct QueryEngine {
+    int num_vertices;
+    long long* offsets;          // CSR snapshot
+    int* targets;
+    int* weights;
+
+    int num_threads;
+    QueryWorker* workers;        // workers[0] runs on the calling thread
+    pthread_t* threads;
+
+    // Current batch
+    PathQuery* queries;
+    int num_queries;
+    QueryMode mode;
+    atomic_int next_query;
+
+    // Pool control
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    unsigned long batch_id;
+    int busy_workers;
+    bool shutdown;
+};
+
+#define QUERY_CHUNK 16           // Queries claimed per atomic increment
+
+/**
+ * Start a new query in this scratch: O(1) except on generation wrap
+ */
+static inline void query_scratch_begin(QueryScratch* s, int V) {
+    if (++s->generation == 0) {
+        memset(s->stamp, 0, V * sizeof(unsigned));
+        s->generation = 1;
+    }
+}
+
+static inline bool query_visited(const QueryScratch* s, int v) {
+    return s->stamp[v] == s->generation;
+}
+
+static inline int query_dist(const QueryScratch* s, int v) {
+    return s->stamp[v] == s->generation ? s->dist[v] : INF;
+}
+
+static inline void query_label(QueryScratch* s, int v, int d, int parent) {
+    s->stamp[v] = s->generation;
+    s->dist[v] = d;
+    s->parent[v] = parent;
+    s->touched++;
+}
+
+static void query_bfs(QueryEngine* e, QueryScratch* s, PathQuery* q) {
+    int head = 0, tail = 0;
+    query_label(s, q->src, 0, -1);
+    s->queue[tail++] = q->src;
+
+    while (head < tail && !query_visited(s, q->dst)) {
+        int u = s->queue[head++];
+        for (long long k = e->offsets[u]; k < e->offsets[u + 1]; k++) {
+            int v = e->targets[k];
+            if (!query_visited(s, v)) {
+                query_label(s, v, s->dist[u] + 1, u);
+                s->queue[tail++] = v;
+            }
+        }
+    }
+}
+
+static void query_dijkstra(QueryEngine* e, QueryScratch* s, PathQuery* q) {
+    s->heap.size = 0;
+    query_label(s, q->src, 0, -1);
+    min_heap_push(&s->heap, q->src, 0);
+
+    while (s->heap.size > 0) {
+        HeapItem item = min_heap_pop(&s->heap);
+        int u = item.vertex;
+        if (item.dist > s->dist[u]) continue;  // Stale entry
+        if (u == q->dst) break;                // Settled - early exit
+
+        for (long long k = e->offsets[u]; k < e->offsets[u + 1]; k++) {
+            int v = e->targets[k];
+            int nd = s->dist[u] + e->weights[k];
+            if (nd < query_dist(s, v)) {
+                query_label(s, v, nd, u);
+                min_heap_push(&s->heap, v, nd);
+            }
+        }
+    }
+}
+
+static void query_answer(QueryEngine* e, QueryScratch* s, PathQuery* q) {
+    q->distance = INF;
+    q->hops = -1;
+    if (q->src < 0 || q->src >= e->num_vertices || q->dst < 0 || q->dst >= e->num_vertices) {
+        return;
+    }
+
+    query_scratch_begin(s, e->num_vertices);
+    if (e->mode == QUERY_BFS) {
+        query_bfs(e, s, q);
+    } else {
+        query_dijkstra(e, s, q);
+    }
+
+    if (query_visited(s, q->dst)) {
+        q->distance = s->dist[q->dst];
+        q->hops = 0;
+        for (int v = q->dst; s->parent[v] != -1; v = s->parent[v]) q->hops++;
+    }
+}
+
+static void query_worker_drain(QueryWorker* w) {
+    QueryEngine* e = w->engine;
+    while (1) {
+        int start = atomic_fetch_add(&e->next_query, QUERY_CHUNK);
+        if (start >= e->num_queries) break;
+        int end = start + QUERY_CHUNK < e->num_queries ? start + QUERY_CHUNK : e->num_queries;
+        for (int i = start; i < end; i++) {
+            query_answer(e, &w->scratch, &e->queries[i]);
+        }
+    }
+}
+
+static void* query_worker_loop(void* arg) {
+    QueryWorker* w = (QueryWorker*)arg;
+    QueryEngine* e = w->engine;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&e->lock);
+    while (1) {
+        while (e->batch_id == seen && !e->shutdown) {
+            pthread_cond_wait(&e->work_ready, &e->lock);
+        }
+        if (e->shutdown) break;
+        seen = e->batch_id;
+        pthread_mutex_unlock(&e->lock);
+
+        query_worker_drain(w);
+
+        pthread_mutex_lock(&e->lock);
+        if (--e->busy_workers == 0) {
+            pthread_cond_signal(&e->work_done);
+        }
+    }
+    pthread_mutex_unlock(&e->lock);
+    return NULL;
+}
+
+/**
+ * Create an engine over a snapshot of graph
+ *
+ * Later changes to graph are not seen by the engine.
+ */
+QueryEngine* query_engine_create(Graph* graph, int num_threads) {
+    int V = graph->num_vertices;
+    if (num_threads < 1) num_threads = 1;
+
+    QueryEngine* e = (QueryEngine*)calloc(1, sizeof(QueryEngine));
+    e->num_vertices = V;
+    e->num_threads = num_threads;
+
+    // CSR snapshot
+    e->offsets = (long long*)malloc((V + 1) * sizeof(long long));
+    long long arcs = 0;
+    for (int u = 0; u < V; u++) {
+        e->offsets[u] = arcs;
+        FOR_EACH_ARC(graph, u, v, w, { (void)v; (void)w; arcs++; });
+    }
+    e->offsets[V] = arcs;
+    e->targets = (int*)malloc((arcs > 0 ? arcs : 1) * sizeof(int));
+    e->weights = (int*)malloc((arcs > 0 ? arcs : 1) * sizeof(int));
+    long long k = 0;
+    for (int u = 0; u < V; u++) {
+        FOR_EACH_ARC(graph, u, v, w, {
+            e->targets[k] = v;
+            e->weights[k] = w;
+            k++;
+        });
+    }
+
+    // Per-worker scratch, allocated once
+    e->workers = (QueryWorker*)calloc(num_threads, sizeof(QueryWorker));
+    for (int t = 0; t < num_threads; t++) {
+        QueryScratch* s = &e->workers[t].scratch;
+        e->workers[t].engine = e;
+        s->dist = (int*)malloc(V * sizeof(int));
+        s->parent = (int*)malloc(V * sizeof(int));
+        s->stamp = (unsigned*)calloc(V, sizeof(unsigned));
+        s->queue = (int*)malloc(V * sizeof(int));
+        min_heap_init(&s->heap, 64);
+    }
+
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->work_ready, NULL);
+    pthread_cond_init(&e->work_done, NULL);
+    atomic_init(&e->next_query, 0);
+
+    e->threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    for (int t = 1; t < num_threads; t++) {
+        pthread_create(&e->threads[t], NULL, query_worker_loop, &e->workers[t]);
+    }
+
+    return e;
+}
+
+/**
+ * Answer a batch of queries in place (fills distance and hops)
+ *
+ * The calling thread works as worker 0; returns when all are answered.
+ */
+void query_engine_run(QueryEngine* e, PathQuery* queries, int num_queries, QueryMode mode) {
+    pthread_mutex_lock(&e->lock);
+    e->queries = queries;
+    e->num_queries = num_queries;
+    e->mode = mode;
+    atomic_store(&e->next_query, 0);
+    e->busy_workers = e->num_threads - 1;
+    e->batch_id++;
+    pthread_cond_broadcast(&e->work_ready);
+    pthread_mutex_unlock(&e->lock);
+
+    query_worker_drain(&e->workers[0]);
+
+    pthread_mutex_lock(&e->lock);
+    while (e->busy_workers > 0) {
+        pthread_cond_wait(&e->work_done, &e->lock);
+    }
+    pthread_mutex_unlock(&e->lock);
+}
+
+/**
+ * Total vertices labeled by all workers since creation
+ */
+long long query_engine_touched(const QueryEngine* e) {
+    long long total = 0;
+    for (int t = 0; t < e->num_threads; t++) total += e->workers[t].scratch.touched;
+    return total;
+}
+
+void query_engine_destroy(QueryEngine* e) {
+    pthread_mutex_lock(&e->lock);
+    e->shutdown = true;
+    pthread_cond_broadcast(&e->work_ready);
+    pthread_mutex_unlock(&e->lock);
+    for (int t = 1; t < e->num_threads; t++) {
+        pthread_join(e->threads[t], NULL);
+    }
+
+    for (int t = 0; t < e->num_threads; t++) {
+        QueryScratch* s = &e->workers[t].scratch;
+        free(s->dist);
+        free(s->parent);
+        free(s->stamp);
+        free(s->queue);
+        min_heap_free(&s->heap);
+    }
+    pthread_mutex_destroy(&e->lock);
+    pthread_cond_destroy(&e->work_ready);
+    pthread_cond_destroy(&e->work_done);
+    free(e->workers);
+    free(e->threads);
+    free(e->offsets);
+    free(e->targets);
+    free(e->weights);
+    free(e);
+}
+
+// ============================================================
+// PARALLEL BIPARTITENESS - Union-find with parity
+// ============================================================
+
+/**
+ * Parallel two-coloring
+ *
+ * BFS coloring is inherently serial per component. Instead, each edge
+ * (u,v) is a CONSTRAINT "u and v get different colors", and all edges
+ * can be processed in parallel with a lock-free union-find that also
+ * tracks PARITY (color relative to parent):
+ *
+ *   word[v] = parent(v) << 32 | parity(v → parent)   (one atomic uint64)
+ *
+ * find(v):  follow parents, XOR-ing parities → (root, color relative to root)
+ *           path halving: CAS word[v] to (grandparent, p(v)⊕p(parent))
+ * union(u,v): (ru,pu) = find(u), (rv,pv) = find(v)
+ *   ru == rv: pu == pv → ODD CYCLE → not bipartite
+ *   ru != rv: CAS the larger root onto the smaller with parity pu⊕pv⊕1
+ *
+ * Why this is safe without locks:
+ * - A root is linked only by a CAS that checks it is still a root
+ * - Parents always have smaller IDs → no cycles
+ * - Relations "v has parity p relative to ancestor a" never become
+ *   false, so stale reads during find/compression remain correct
+ *
+ * Pass 2 (parallel): color[v] = parity of v relative to its final root.
+ * Roots are the smallest vertex of each component, so on undirected
+ * graphs the sets match the serial BFS coloring exactly.
+ *
+ * Directed arcs are treated as undirected constraints.
+ *
+ * Time: O(E α(V) / threads)   Space: O(V)
+ */
+typedef struct {
+    Graph* graph;
+    _Atomic uint64_t* words;
+    int first;                   // Vertex range [first, last) for this thread
+    int last;
+    atomic_bool* conflict;
+    int conflict_u;              // First odd-cycle edge found by this thread
+    int conflict_v;
+    int* set;
+    int set_sizes[2];
+} ParityWorker;
+
+#define PARITY_WORD(parent, parity) (((uint64_t)(uint32_t)(parent) << 32) | (uint64_t)(parity))
+#define PARITY_PARENT(word) ((int)((word) >> 32))
+#define PARITY_BIT(word) ((int)((word) & 1))
+
+/**
+ * Find root of v; *parity receives v's color relative to the root
+ */
+static int parity_find(_Atomic uint64_t* words, int v, int* parity) {
+    int p = 0;
+    while (1) {
+        uint64_t w = atomic_load_explicit(&words[v], memory_order_acquire);
+        int parent = PARITY_PARENT(w);
+        if (parent == v) break;
+
+        uint64_t pw = atomic_load_explicit(&words[parent], memory_order_acquire);
+        int grand = PARITY_PARENT(pw);
+        if (grand != parent) {
+            // Path halving; losing the race is harmless
+            uint64_t halved = PARITY_WORD(grand, PARITY_BIT(w) ^ PARITY_BIT(pw));
+            atomic_compare_exchange_weak_explicit(&words[v], &w, halved,
+                                                  memory_order_release, memory_order_relaxed);
+        }
+        p ^= PARITY_BIT(w);
+        v = parent;
+    }
+    *parity = p;
+    return v;
+}
+
+/**
+ * Record constraint color(u) != color(v)
+ * Returns false if it closes an odd cycle
+ */
+static bool parity_union(_Atomic uint64_t* words, int u, int v) {
+    while (1) {
+        int pu, pv;
+        int ru = parity_find(words, u, &pu);
+        int rv = parity_find(words, v, &pv);
+        if (ru == rv) return pu != pv;
+
+        // Link larger root under smaller
+        int child = ru > rv ? ru : rv;
+        int parent = ru > rv ? rv : ru;
+        uint64_t expected = PARITY_WORD(child, 0);
+        if (atomic_compare_exchange_strong_explicit(&words[child], &expected,
+                                                    PARITY_WORD(parent, pu ^ pv ^ 1),
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            return true;
+        }
+        // Child stopped being a root - retry with fresh roots
+    }
+}
+
+static void* parity_union_worker(void* arg) {
+    ParityWorker* w = (ParityWorker*)arg;
+    bool undirected = w->graph->type == UNDIRECTED;
+    for (int u = w->first; u < w->last; u++) {
+        if (atomic_load_explicit(w->conflict, memory_order_relaxed)) break;
+        FOR_EACH_ARC(w->graph, u, v, wt, {
+            (void)wt;
+            if (undirected && v < u) continue;  // Each edge is stored twice
+            if (!parity_union(w->words, u, v) && w->conflict_u < 0) {
+                w->conflict_u = u;
+                w->conflict_v = v;
+                atomic_store(w->conflict, true);
+            }
+        });
+    }
+    return NULL;
+}
+
+static void* parity_color_worker(void* arg) {
+    ParityWorker* w = (ParityWorker*)arg;
+    for (int v = w->first; v < w->last; v++) {
+        int parity;
+        parity_find(w->words, v, &parity);
+        w->set[v] = parity;
+        w->set_sizes[parity]++;
+    }
+    return NULL;
+}
+
+static void parity_run_phase(ParityWorker* workers, int num_threads, void* (*fn)(void*)) {
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    for (int t = 1; t < num_threads; t++) {
+        pthread_create(&threads[t], NULL, fn, &workers[t]);
+    }
+    fn(&workers[0]);
+    for (int t = 1; t < num_threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+}
+
+/**
+ * Parallel bipartiteness check with partition sets
+ *
+ * Same contract as is_bipartite_with_sets(): set[v] ∈ {0,1} and
+ * set_sizes[0..1] are filled when the graph is bipartite.
+ *
+ * @param conflict  Optional (may be NULL): an edge closing an odd cycle
+ *                  when the graph is not bipartite, else {-1, -1}
+ */
+bool graph_is_bipartite_parallel(Graph* graph, int num_threads, int* set, int* set_sizes,
+                                 int conflict[2]) {
+    int V = graph->num_vertices;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > V && V > 0) num_threads = V;
+
+    _Atomic uint64_t* words = (_Atomic uint64_t*)malloc((V > 0 ? V : 1) * sizeof(_Atomic uint64_t));
+    for (int v = 0; v < V; v++) atomic_init(&words[v], PARITY_WORD(v, 0));
+
+    atomic_bool found_conflict;
+    atomic_init(&found_conflict, false);
+
+    // Split vertices into ranges of roughly equal arc counts
+    long long arcs = 0;
+    for (int u = 0; u < V; u++) FOR_EACH_ARC(graph, u, v, w, { (void)v; (void)w; arcs++; });
+
+    ParityWorker* workers = (ParityWorker*)calloc(num_threads, sizeof(ParityWorker));
+    long long seen = 0;
+    int u = 0;
+    for (int t = 0; t < num_threads; t++) {
+        ParityWorker* w = &workers[t];
+        w->graph = graph;
+        w->words = words;
+        w->conflict = &found_conflict;
+        w->conflict_u = w->conflict_v = -1;
+        w->set = set;
+        w->first = u;
+        long long target = (arcs + V) * (t + 1) / num_threads;
+        while (u < V && (seen < target || t == num_threads - 1)) {
+            FOR_EACH_ARC(graph, u, v, wt, { (void)v; (void)wt; seen++; });
+            seen++;
+            u++;
+        }
+        w->last = u;
+    }
+
+    parity_run_phase(workers, num_threads, parity_union_worker);
+
+    bool bipartite = !atomic_load(&found_conflict);
+    if (conflict != NULL) {
+        conflict[0] = conflict[1] = -1;
+        for (int t = 0; t < num_threads; t++) {
+            if (workers[t].conflict_u >= 0) {
+                conflict[0] = workers[t].conflict_u;
+                conflict[1] = workers[t].conflict_v;
+                break;
+            }
+        }
+    }
+
+    if (bipartite) {
+        // Colors only read final roots now - rebalance by vertex count
+        for (int t = 0; t < num_threads; t++) {
+            workers[t].first = (int)((long long)V * t / num_threads);
+            workers[t].last = (int)((long long)V * (t + 1) / num_threads);
+        }
+        parity_run_phase(workers, num_threads, parity_color_worker);
+        set_sizes[0] = set_sizes[1] = 0;
+        for (int t = 0; t < num_threads; t++) {
+            set_sizes[0] += workers[t].set_sizes[0];
+            set_sizes[1] += workers[t].set_sizes[1];
+        }
+    }
+
+    free(workers);
+    free(words);
+    return bipartite;
+}
+
+// ============================================================
+// STREAMING EXPORT - Buffered, multi-threaded DOT/GraphML/binary
+// ============================================================
+
+/**
+ * Streaming graph export
+ *
+ * graph_export_dot() issues several fprintf calls per edge - format
+ * string parsing and stdio locking dominate on large graphs.
+ *
+ * Here the vertex range is cut into chunks of EXPORT_CHUNK_VERTICES.
+ * Each round:
+ * 1. Every thread formats one chunk into its own buffer with a
+ *    hand-written integer formatter (no printf)
+ * 2. Thread 0 writes the buffers IN ORDER with one fwrite each
+ *    (unbuffered FILE → one large write syscall per chunk)
+ * Output is byte-identical for any thread count.
+ *
+ * Limiting output:
+ * - max_edges:   stop after this many edges; truncation happens at a
+ *                record boundary (each chunk remembers where every
+ *                edge record ends)
+ * - sample_rate: keep an edge iff hash(u, v, seed) < rate - the same
+ *                edges are kept on every run and for any thread count
+ *
+ * Undirected edges are written once (u <= v), as in graph_export_dot().
+ *
+ * Binary edge list (host byte order):
+ *   header: "GEDG" | u32 version=1 | u32 flags (1=directed, 2=weighted)
+ *           | u32 num_vertices | u64 num_edges
+ *   record: i32 src | i32 dst [| i32 weight]
+ */
+typedef enum {
+    EXPORT_DOT,
+    EXPORT_GRAPHML,
+    EXPORT_BINARY_EDGE_LIST
+} ExportFormat;
+
+typedef struct {
+    ExportFormat format;
+    int num_threads;
+    long long max_edges;         // 0 = no limit
+    double sample_rate;          // 1.0 = every edge
+    uint64_t sample_seed;
+} ExportOptions;
+
+#define EXPORT_CHUNK_VERTICES 4096
+#define EXPORT_RECORD_MAX 96     // Upper bound on one formatted edge
+
+typedef struct {
+    ByteBuffer out;
+    size_t* edge_ends;           // Byte offset after each edge record
+    long long num_records;
+    long long records_capacity;
+} ExportChunk;
+
+typedef struct {
+    Graph* graph;
+    const ExportOptions* opts;
+    FILE* fp;
+    ExportChunk* chunks;         // One per thread
+    int num_threads;
+    pthread_barrier_t barrier;
+    int round_start;             // First vertex of the current round
+    long long written;
+    bool done;
+    bool failed;
+} ExportJob;
+
+typedef struct {
+    ExportJob* job;
+    int thread_id;
+} ExportWorkerArg;
+
+static inline uint8_t* format_uint(uint8_t* p, unsigned long long x) {
+    uint8_t digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (uint8_t)('0' + x % 10);
+        x /= 10;
+    } while (x > 0);
+    while (n > 0) *p++ = digits[--n];
+    return p;
+}
+
+static inline uint8_t* format_int(uint8_t* p, long long x) {
+    if (x < 0) {
+        *p++ = '-';
+        return format_uint(p, 0ULL - (unsigned long long)x);
+    }
+    return format_uint(p, (unsigned long long)x);
+}
+
+static inline uint8_t* format_str(uint8_t* p, const char* s) {
+    while (*s) *p++ = (uint8_t)*s++;
+    return p;
+}
 
-    int V = graph->num_vertices;
-    int E = graph->num_edges;
+static inline bool export_keep_edge(const ExportOptions* opts, int u, int v) {
+    if (opts->sample_rate >= 1.0) return true;
+    uint64_t h = mix64(edge_index_key(u, v) ^ opts->sample_seed);
+    return (double)(h >> 11) * (1.0 / 9007199254740992.0) < opts->sample_rate;
+}
 
-    // Step 1: Collect all edges
-    printf("Step 1: Collecting all edges...\n");
-    Edge* edges = (Edge*)malloc(E * sizeof(Edge));
-    int edge_count = 0;
+static void export_format_edge(ExportChunk* c, const Graph* graph, ExportFormat format,
+                               int u, int v, int w) {
+    if (c->out.size + EXPORT_RECORD_MAX > c->out.capacity) {
+        c->out.capacity = c->out.capacity * 2 + 4096;
+        c->out.bytes = (uint8_t*)realloc(c->out.bytes, c->out.capacity);
+    }
+    if (c->num_records == c->records_capacity) {
+        c->records_capacity = c->records_capacity * 2 + 1024;
+        c->edge_ends = (size_t*)realloc(c->edge_ends, c->records_capacity * sizeof(size_t));
+    }
 
-    if (graph->representation == ADJACENCY_LIST) {
-        for (int u = 0; u < V; u++) {
-            AdjListNode* node = graph->adj_list[u];
-            while (node != NULL) {
-                int v = node->dest;
-                // For undirected graph, only add edge once (u < v)
-                if (u < v) {
-                    edges[edge_count].u = u;
-                    edges[edge_count].v = v;
-                    edges[edge_count].weight = node->weight;
-                    edge_count++;
-                }
-                node = node->next;
-            }
+    uint8_t* p = c->out.bytes + c->out.size;
+    bool weighted = graph->weight_type == WEIGHTED;
+
+    if (format == EXPORT_DOT) {
+        p = format_str(p, "  ");
+        p = format_int(p, u);
+        p = format_str(p, graph->type == DIRECTED ? " -> " : " -- ");
+        p = format_int(p, v);
+        if (weighted) {
+            p = format_str(p, " [label=\"");
+            p = format_int(p, w);
+            p = format_str(p, "\"]");
         }
-    } else {
-        for (int u = 0; u < V; u++) {
-            for (int v = u + 1; v < V; v++) {  // u < v for undirected
-                if (graph->adj_matrix[u][v] != NO_EDGE) {
-                    edges[edge_count].u = u;
-                    edges[edge_count].v = v;
-                    edges[edge_count].weight = graph->adj_matrix[u][v];
-                    edge_count++;
-                }
-            }
+        p = format_str(p, ";\n");
+    } else if (format == EXPORT_GRAPHML) {
+        p = format_str(p, "    <edge source=\"n");
+        p = format_int(p, u);
+        p = format_str(p, "\" target=\"n");
+        p = format_int(p, v);
+        if (weighted) {
+            p = format_str(p, "\"><data key=\"w\">");
+            p = format_int(p, w);
+            p = format_str(p, "</data></edge>\n");
+        } else {
+            p = format_str(p, "\"/>\n");
         }
+    } else {
+        int32_t rec[3] = {u, v, w};
+        size_t len = (weighted ? 3 : 2) * sizeof(int32_t);
+        memcpy(p, rec, len);
+        p += len;
     }
 
-    printf("        Found %d edges\n\n", edge_count);
-
-    // Step 2: Sort edges by weight
-    printf("Step 2: Sorting edges by weight...\n");
-    qsort(edges, edge_count, sizeof(Edge), compare_edges);
+    c->out.size = (size_t)(p - c->out.bytes);
+    c->edge_ends[c->num_records++] = c->out.size;
+}
 
-    printf("        Sorted edge list:\n");
-    for (int i = 0; i < edge_count; i++) {
-        printf("        %d-%d (weight: %d)\n",
-               edges[i].u, edges[i].v, edges[i].weight);
+static void export_format_chunk(ExportJob* job, ExportChunk* c, int first, int last) {
+    Graph* graph = job->graph;
+    c->out.size = 0;
+    c->num_records = 0;
+
+    for (int u = first; u < last; u++) {
+        FOR_EACH_ARC(graph, u, v, w, {
+            if (graph->type == UNDIRECTED && u > v) continue;
+            if (!export_keep_edge(job->opts, u, v)) continue;
+            export_format_edge(c, graph, job->opts->format, u, v, w);
+        });
     }
-    printf("\n");
-
-    // Step 3: Initialize Union-Find
-    printf("Step 3: Initializing Union-Find...\n");
-    UnionFind* uf = uf_create(V);
-    printf("        Each vertex starts in its own component\n\n");
+}
 
-    // Step 4: Process edges in sorted order
-    printf("Step 4: Processing edges (adding if no cycle):\n\n");
-    Edge* mst = (Edge*)malloc((V - 1) * sizeof(Edge));
-    *mst_size = 0;
-    int total_weight = 0;
-    int step = 0;
+/**
+ * Write formatted chunks in order, honoring max_edges (thread 0 only)
+ */
+static void export_flush_round(ExportJob* job) {
+    for (int t = 0; t < job->num_threads && !job->done; t++) {
+        ExportChunk* c = &job->chunks[t];
+        long long records = c->num_records;
+        size_t bytes = c->out.size;
+
+        if (job->opts->max_edges > 0 && job->written + records >= job->opts->max_edges) {
+            records = job->opts->max_edges - job->written;
+            bytes = records > 0 ? c->edge_ends[records - 1] : 0;
+            job->done = true;
+        }
 
-    for (int i = 0; i < edge_count && *mst_size < V - 1; i++) {
-        int u = edges[i].u;
-        int v = edges[i].v;
-        int weight = edges[i].weight;
-
-        // Check if u and v are in different components
-        int root_u = uf_find(uf, u);
-        int root_v = uf_find(uf, v);
-
-        printf("Edge %d-%d (weight: %d): ", u, v, weight);
-
-        if (root_u != root_v) {
-            // Different components - add edge to MST
-            printf("✓ ADDED (connects components %d and %d)\n", root_u, root_v);
-            mst[*mst_size] = edges[i];
-            (*mst_size)++;
-            total_weight += weight;
-            uf_union(uf, u, v);
-            step++;
-        } else {
-            // Same component - would create cycle
-            printf("✗ SKIPPED (would create cycle, both in component %d)\n", root_u);
+        if (bytes > 0 && fwrite(c->out.bytes, 1, bytes, job->fp) != bytes) {
+            job->failed = true;
+            job->done = true;
         }
+        job->written += records;
     }
 
-    printf("\nKruskal's MST Complete!\n");
-    printf("Total MST weight: %d\n", total_weight);
-    printf("Edges in MST: %d\n", *mst_size);
+    job->round_start += job->num_threads * EXPORT_CHUNK_VERTICES;
+    if (job->round_start >= job->graph->num_vertices) job->done = true;
+}
 
-    free(edges);
-    uf_destroy(uf);
+static void* export_worker_run(void* arg) {
+    ExportWorkerArg* a = (ExportWorkerArg*)arg;
+    ExportJob* job = a->job;
+    int V = job->graph->num_vertices;
 
-    return mst;
+    while (1) {
+        long long first = (long long)job->round_start + (long long)a->thread_id * EXPORT_CHUNK_VERTICES;
+        long long last = first + EXPORT_CHUNK_VERTICES;
+        if (first > V) first = V;
+        if (last > V) last = V;
+        export_format_chunk(job, &job->chunks[a->thread_id], (int)first, (int)last);
+
+        pthread_barrier_wait(&job->barrier);
+        if (a->thread_id == 0) export_flush_round(job);
+        pthread_barrier_wait(&job->barrier);
+
+        if (job->done) break;
+    }
+    return NULL;
+}
+
+// Returns false if writing the header failed
+static bool export_write_header(ExportJob* job) {
+    Graph* graph = job->graph;
+    FILE* fp = job->fp;
+
+    if (job->opts->format == EXPORT_DOT) {
+        fprintf(fp, "%s G {\n", graph->type == DIRECTED ? "digraph" : "graph");
+        fprintf(fp, "  layout=neato;\n  overlap=false;\n  splines=true;\n");
+        fprintf(fp, "  node [shape=circle, style=filled, fillcolor=lightblue];\n\n");
+    } else if (job->opts->format == EXPORT_GRAPHML) {
+        fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        fprintf(fp, "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n");
+        if (graph->weight_type == WEIGHTED) {
+            fprintf(fp, "  <key id=\"w\" for=\"edge\" attr.name=\"weight\" attr.type=\"int\"/>\n");
+        }
+        fprintf(fp, "  <graph id=\"G\" edgedefault=\"%s\">\n",
+                graph->type == DIRECTED ? "directed" : "undirected");
+
+        // All nodes up front, so a truncated edge list still references declared nodes
+        ExportChunk* c = &job->chunks[0];
+        c->out.size = 0;
+        for (int v = 0; v < graph->num_vertices; v++) {
+            if (c->out.size + EXPORT_RECORD_MAX > c->out.capacity) {
+                if (c->out.size > 0) fwrite(c->out.bytes, 1, c->out.size, fp);
+                c->out.size = 0;
+                if (c->out.capacity < 65536) {
+                    c->out.capacity = 65536;
+                    c->out.bytes = (uint8_t*)realloc(c->out.bytes, c->out.capacity);
+                }
+            }
+            uint8_t* p = c->out.bytes + c->out.size;
+            p = format_str(p, "    <node id=\"n");
+            p = format_int(p, v);
+            p = format_str(p, "\"/>\n");
+            c->out.size = (size_t)(p - c->out.bytes);
+        }
+        if (c->out.size > 0) fwrite(c->out.bytes, 1, c->out.size, fp);
+    } else {
+        uint32_t header[4];
+        memcpy(&header[0], "GEDG", 4);
+        header[1] = 1;
+        header[2] = (graph->type == DIRECTED ? 1u : 0u) | (graph->weight_type == WEIGHTED ? 2u : 0u);
+        header[3] = (uint32_t)graph->num_vertices;
+        uint64_t num_edges = 0;  // Patched after the edges are written
+        fwrite(header, sizeof(header), 1, fp);
+        fwrite(&num_edges, sizeof(num_edges), 1, fp);
+    }
+    return !ferror(fp);
+}
+
+static void export_write_footer(ExportJob* job) {
+    if (job->opts->format == EXPORT_DOT) {
+        fprintf(job->fp, "}\n");
+    } else if (job->opts->format == EXPORT_GRAPHML) {
+        fprintf(job->fp, "  </graph>\n</graphml>\n");
+    } else {
+        uint64_t num_edges = (uint64_t)job->written;
+        fseek(job->fp, 4 * sizeof(uint32_t), SEEK_SET);
+        fwrite(&num_edges, sizeof(num_edges), 1, job->fp);
+    }
 }
 
 /**
- * Display MST edges
+ * Export graph to filename in the given format
+ *
+ * @param opts  NULL = DOT, 1 thread, every edge
+ * @return      Number of edges written, or -1 on I/O error
  */
-void display_mst(Edge* mst, int mst_size) {
-    printf("\nMST Edges:\n");
-    int total = 0;
-    for (int i = 0; i < mst_size; i++) {
-        printf("  %d -- %d  (weight: %d)\n", mst[i].u, mst[i].v, mst[i].weight);
-        total += mst[i].weight;
+long long graph_export(Graph* graph, const char* filename, const ExportOptions* opts) {
+    ExportOptions defaults = {EXPORT_DOT, 1, 0, 1.0, 0};
+    if (opts == NULL) opts = &defaults;
+
+    FILE* fp = fopen(filename, opts->format == EXPORT_BINARY_EDGE_LIST ? "wb" : "w");
+    if (!fp) {
+        printf("Error: Could not open %s for writing\n", filename);
+        return -1;
     }
-    printf("\nTotal weight: %d\n", total);
+    setvbuf(fp, NULL, _IONBF, 0);  // Chunks are already large
+
+    ExportJob job;
+    memset(&job, 0, sizeof(job));
+    job.graph = graph;
+    job.opts = opts;
+    job.fp = fp;
+    job.num_threads = opts->num_threads > 0 ? opts->num_threads : 1;
+    job.chunks = (ExportChunk*)calloc(job.num_threads, sizeof(ExportChunk));
+    job.done = graph->num_vertices == 0;
+    pthread_barrier_init(&job.barrier, NULL, job.num_threads);
+
+    if (!export_write_header(&job)) {
+        job.failed = true;
+        job.done = true;         // No point writing edges after a short header
+    }
+
+    if (!job.done) {
+        ExportWorkerArg* args = (ExportWorkerArg*)malloc(job.num_threads * sizeof(ExportWorkerArg));
+        pthread_t* threads = (pthread_t*)malloc(job.num_threads * sizeof(pthread_t));
+        for (int t = 0; t < job.num_threads; t++) {
+            args[t].job = &job;
+            args[t].thread_id = t;
+        }
+        for (int t = 1; t < job.num_threads; t++) {
+            pthread_create(&threads[t], NULL, export_worker_run, &args[t]);
+        }
+        export_worker_run(&args[0]);
+        for (int t = 1; t < job.num_threads; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        free(args);
+        free(threads);
+    }
+
+    export_write_footer(&job);
+    if (ferror(fp)) job.failed = true;
+    if (fclose(fp) != 0) job.failed = true;
+
+    pthread_barrier_destroy(&job.barrier);
+    for (int t = 0; t < job.num_threads; t++) {
+        free(job.chunks[t].out.bytes);
+        free(job.chunks[t].edge_ends);
+    }
+    free(job.chunks);
+
+    return job.failed ? -1 : job.written;
 }
 
 // ============================================================
@@ -2717,10 +6121,989 @@ void test_floyd_warshall() {
     graph_destroy(graph3);
 }
 
+void test_betweenness_centrality() {
+    printf("\n=== Test 15: Betweenness Centrality (Brandes) ===\n\n");
+
+    // Test 1: Small unweighted graph (BFS-based)
+    printf("--- Test 15a: Unweighted Undirected Graph (BFS) ---\n\n");
+    Graph* graph = graph_create(6, UNDIRECTED, UNWEIGHTED, ADJACENCY_LIST);
+
+    graph_add_edge(graph, 0, 1, 1);
+    graph_add_edge(graph, 0, 2, 1);
+    graph_add_edge(graph, 1, 3, 1);
+    graph_add_edge(graph, 2, 3, 1);
+    graph_add_edge(graph, 2, 4, 1);
+    graph_add_edge(graph, 3, 5, 1);
+    graph_add_edge(graph, 4, 5, 1);
+
+    graph_display_list(graph);
+
+    double* cb = graph_betweenness_centrality(graph, 2);
+    printf("\nVertex | Betweenness\n");
+    printf("-------|------------\n");
+    for (int i = 0; i < graph->num_vertices; i++) {
+        printf("  %2d   | %8.3f\n", i, cb[i]);
+    }
+    free(cb);
+    graph_destroy(graph);
+
+    // Test 2: Weighted directed graph (Dijkstra-based)
+    printf("\n--- Test 15b: Weighted Directed Graph (Dijkstra) ---\n\n");
+    Graph* weighted = graph_create(6, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+
+    graph_add_edge(weighted, 0, 1, 4);
+    graph_add_edge(weighted, 0, 2, 2);
+    graph_add_edge(weighted, 1, 2, 1);
+    graph_add_edge(weighted, 1, 3, 5);
+    graph_add_edge(weighted, 2, 3, 8);
+    graph_add_edge(weighted, 2, 4, 10);
+    graph_add_edge(weighted, 3, 4, 2);
+    graph_add_edge(weighted, 3, 5, 6);
+    graph_add_edge(weighted, 4, 5, 3);
+
+    graph_display_list(weighted);
+
+    cb = graph_betweenness_centrality(weighted, 2);
+    printf("\nVertex | Betweenness\n");
+    printf("-------|------------\n");
+    for (int i = 0; i < weighted->num_vertices; i++) {
+        printf("  %2d   | %8.3f\n", i, cb[i]);
+    }
+    free(cb);
+    graph_destroy(weighted);
+
+    // Test 3: Parallel speedup and sampling accuracy
+    printf("\n--- Test 15c: Parallel Exact vs Sampled (k sources) ---\n\n");
+    srand(42);
+    Graph* large = graph_create_sparse(2000, UNDIRECTED, UNWEIGHTED, 8000);
+
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+
+    double t0 = now_seconds();
+    double* serial = graph_betweenness_centrality(large, 1);
+    double t1 = now_seconds();
+    double* parallel = graph_betweenness_centrality(large, threads);
+    double t2 = now_seconds();
+    double* sampled = graph_betweenness_centrality_sampled(large, 200, threads, 7);
+    double t3 = now_seconds();
+
+    double max_diff = 0.0;
+    int top = 0;
+    for (int i = 0; i < large->num_vertices; i++) {
+        double d = fabs(serial[i] - parallel[i]);
+        if (d > max_diff) max_diff = d;
+        if (serial[i] > serial[top]) top = i;
+    }
+
+    printf("Exact, 1 thread:      %.3f s\n", t1 - t0);
+    printf("Exact, %d thread(s):  %.3f s (max diff vs serial: %.2e)\n",
+           threads, t2 - t1, max_diff);
+    printf("Sampled k=200:        %.3f s\n", t3 - t2);
+    printf("\nMost central vertex: %d\n", top);
+    printf("  exact   = %.1f\n", serial[top]);
+    printf("  sampled = %.1f (error %.1f%%)\n", sampled[top],
+           100.0 * fabs(sampled[top] - serial[top]) / serial[top]);
+
+    free(serial);
+    free(parallel);
+    free(sampled);
+    graph_destroy(large);
+
+    // Empty graph: nothing to sample, no scores
+    Graph* empty = graph_create(0, UNDIRECTED, UNWEIGHTED, ADJACENCY_LIST);
+    double* none = graph_betweenness_centrality_sampled(empty, 200, threads, 7);
+    printf("\nEmpty graph, sampled: %s\n", none == NULL ? "NULL (ok)" : "scores (WRONG)");
+    free(none);
+    graph_destroy(empty);
+}
+
+void test_compressed_graph() {
+    printf("\n=== Test 16: Compressed Graph (Gap + Varint Encoding) ===\n\n");
+
+    // Test 1: Small graph - decode and run Dijkstra on compressed form
+    printf("--- Test 16a: Round trip on small weighted graph ---\n\n");
+    Graph* graph = graph_create(6, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+
+    graph_add_edge(graph, 0, 1, 4);
+    graph_add_edge(graph, 0, 2, 2);
+    graph_add_edge(graph, 1, 2, 1);
+    graph_add_edge(graph, 1, 3, 5);
+    graph_add_edge(graph, 2, 3, 8);
+    graph_add_edge(graph, 2, 4, 10);
+    graph_add_edge(graph, 3, 4, 2);
+    graph_add_edge(graph, 3, 5, 6);
+    graph_add_edge(graph, 4, 5, 3);
+
+    CompressedGraph* cg = cgraph_from_graph(graph);
+
+    printf("Decoded neighbor lists (sorted):\n");
+    for (int u = 0; u < cg->num_vertices; u++) {
+        printf("  [%d]: ", u);
+        CGIterator it;
+        int v, w;
+        cgraph_iter_begin(cg, u, &it);
+        while (cgraph_iter_next(&it, &v, &w)) {
+            printf("%d(w=%d) ", v, w);
+        }
+        printf("(%llu bytes)\n", (unsigned long long)(cg->offsets[u + 1] - cg->offsets[u]));
+    }
+
+    int* distance = (int*)malloc(cg->num_vertices * sizeof(int));
+    cgraph_dijkstra(cg, 0, distance);
+    printf("\nDijkstra from 0 on compressed graph: ");
+    for (int i = 0; i < cg->num_vertices; i++) {
+        printf("%d ", distance[i]);
+    }
+    printf("\n(Expected: 0 4 2 9 11 14)\n");
+    free(distance);
+
+    cgraph_destroy(cg);
+    graph_destroy(graph);
+
+    // Test 2: Larger graph - memory and verification
+    printf("\n--- Test 16b: Memory footprint on a larger sparse graph ---\n\n");
+    srand(42);
+    Graph* large = graph_create_sparse(20000, UNDIRECTED, WEIGHTED, 100000);
+    cg = cgraph_from_graph(large);
+
+    // Verify every decoded arc exists with the same weight
+    long long checked = 0, mismatches = 0;
+    for (int u = 0; u < cg->num_vertices; u++) {
+        CGIterator it;
+        int v, w;
+        cgraph_iter_begin(cg, u, &it);
+        while (cgraph_iter_next(&it, &v, &w)) {
+            if (get_edge_weight(large, u, v) != w) mismatches++;
+            checked++;
+        }
+    }
+
+    size_t list_bytes = large->num_vertices * sizeof(AdjListNode*) +
+                        checked * (sizeof(AdjListNode) + 16);  // + malloc header
+    size_t packed_bytes = cgraph_memory_bytes(cg);
+
+    printf("Arcs verified:     %lld (%lld mismatches)\n", checked, mismatches);
+    printf("Adjacency list:    ~%zu bytes (%.1f bytes/arc incl. malloc overhead)\n",
+           list_bytes, (double)list_bytes / checked);
+    printf("Compressed:        %zu bytes (%.2f bytes/arc, %.2f in edge stream)\n",
+           packed_bytes, (double)packed_bytes / checked, (double)cg->data_size / checked);
+    printf("Reduction:         %.1fx\n", (double)list_bytes / packed_bytes);
+
+    // Same graph from its edge list, built in small chunks (many passes)
+    Edge* edge_list = (Edge*)malloc(checked * sizeof(Edge));
+    long long num_listed = 0;
+    for (int u = 0; u < large->num_vertices; u++) {
+        for (AdjListNode* node = large->adj_list[u]; node != NULL; node = node->next) {
+            if (u <= node->dest) edge_list[num_listed++] = (Edge){u, node->dest, node->weight};
+        }
+    }
+    CompressedGraph* from_edges = cgraph_from_edges_chunked(
+        large->num_vertices, UNDIRECTED, WEIGHTED, edge_list, num_listed, 4096);
+    bool same = from_edges && from_edges->data_size == cg->data_size &&
+                memcmp(from_edges->data, cg->data, cg->data_size) == 0 &&
+                memcmp(from_edges->offsets, cg->offsets,
+                       (cg->num_vertices + 1) * sizeof(uint64_t)) == 0;
+    edge_list[0].v = large->num_vertices;  // Endpoint out of range
+    CompressedGraph* bad = cgraph_from_edges(large->num_vertices, UNDIRECTED, WEIGHTED,
+                                             edge_list, num_listed);
+    printf("From edge list (4096-arc chunks): %s | Bad endpoint rejected: %s\n",
+           same ? "identical encoding" : "DIFFERS", bad == NULL ? "yes" : "NO");
+    if (from_edges) cgraph_destroy(from_edges);
+    if (bad) cgraph_destroy(bad);
+    free(edge_list);
+
+    // Run the three workloads on the compressed form
+    int* bfs_dist = (int*)malloc(cg->num_vertices * sizeof(int));
+    int* sp_dist = (int*)malloc(cg->num_vertices * sizeof(int));
+    double* rank = (double*)malloc(cg->num_vertices * sizeof(double));
+
+    double t0 = now_seconds();
+    int reached = cgraph_bfs(cg, 0, bfs_dist);
+    double t1 = now_seconds();
+    cgraph_dijkstra(cg, 0, sp_dist);
+    double t2 = now_seconds();
+    int iters = cgraph_pagerank(cg, 0.85, 100, 1e-9, rank);
+    double t3 = now_seconds();
+
+    int best = 0;
+    for (int i = 1; i < cg->num_vertices; i++) {
+        if (rank[i] > rank[best]) best = i;
+    }
+
+    printf("\nBFS:       %d vertices reached in %.4f s\n", reached, t1 - t0);
+    printf("Dijkstra:  dist(0, %d) = %d in %.4f s\n",
+           cg->num_vertices - 1, sp_dist[cg->num_vertices - 1], t2 - t1);
+    printf("PageRank:  %d iterations in %.4f s, top vertex %d (%.6f)\n",
+           iters, t3 - t2, best, rank[best]);
+
+    free(bfs_dist);
+    free(sp_dist);
+    free(rank);
+    cgraph_destroy(cg);
+    graph_destroy(large);
+}
+
+void test_bitset_matrix() {
+    printf("\n=== Test 17: Bitset Adjacency Matrix (Unweighted) ===\n\n");
+
+    // Test 1: Complete graph K6 - every pair shares V-2 neighbors
+    printf("--- Test 17a: Neighbor intersection and triangles ---\n\n");
+    Graph* complete = graph_create_complete(6, UNDIRECTED, UNWEIGHTED);
+    BitMatrix* bm = bitmatrix_from_graph(complete);
+
+    printf("Common neighbors of 0 and 1: %d (expected 4)\n",
+           bitmatrix_common_neighbors(bm, 0, 1));
+    printf("Triangles in K6: %lld (expected C(6,3) = 20)\n",
+           bitmatrix_count_triangles(bm));
+
+    bitmatrix_destroy(bm);
+    graph_destroy(complete);
+
+    // Test 2: Closure of the course prerequisite DAG
+    printf("\n--- Test 17b: Transitive closure (who depends on whom) ---\n\n");
+    Graph* dag = graph_create(6, DIRECTED, UNWEIGHTED, ADJACENCY_LIST);
+    graph_add_edge(dag, 0, 2, 1);
+    graph_add_edge(dag, 1, 2, 1);
+    graph_add_edge(dag, 1, 3, 1);
+    graph_add_edge(dag, 2, 4, 1);
+    graph_add_edge(dag, 3, 4, 1);
+    graph_add_edge(dag, 4, 5, 1);
+
+    bm = bitmatrix_from_graph(dag);
+    BitMatrix* reach = bitmatrix_transitive_closure(bm);
+
+    printf("Reachability matrix:\n    ");
+    for (int j = 0; j < reach->num_vertices; j++) {
+        printf("%d ", j);
+    }
+    printf("\n");
+    for (int i = 0; i < reach->num_vertices; i++) {
+        printf("%2d: ", i);
+        for (int j = 0; j < reach->num_vertices; j++) {
+            printf("%c ", bitmatrix_has_edge(reach, i, j) ? '1' : '.');
+        }
+        printf("\n");
+    }
+
+    bitmatrix_destroy(reach);
+    bitmatrix_destroy(bm);
+    graph_destroy(dag);
+
+    // Test 3: Dense random graph - memory and BFS agreement
+    printf("\n--- Test 17c: Dense graph - memory and word-parallel BFS ---\n\n");
+    srand(42);
+    int V = 3000;
+    bm = bitmatrix_create(V, UNDIRECTED);
+    Edge* edges = (Edge*)malloc((size_t)V * 300 * sizeof(Edge));
+    long long num_edges = 0;
+    for (int u = 0; u < V; u++) {
+        for (int k = 0; k < 300; k++) {
+            int v = rand() % V;
+            if (u == v) continue;
+            bitmatrix_add_edge(bm, u, v);
+            Edge e = {u, v, 1};
+            edges[num_edges++] = e;
+        }
+    }
+    CompressedGraph* cg = cgraph_from_edges(V, UNDIRECTED, UNWEIGHTED, edges, num_edges);
+    free(edges);
+
+    int* d_bits = (int*)malloc(V * sizeof(int));
+    int* d_ref = (int*)malloc(V * sizeof(int));
+
+    double t0 = now_seconds();
+    int reached = bitmatrix_bfs(bm, 0, d_bits);
+    double t1 = now_seconds();
+    cgraph_bfs(cg, 0, d_ref);
+
+    int mismatches = 0;
+    for (int i = 0; i < V; i++) {
+        if (d_bits[i] != d_ref[i]) mismatches++;
+    }
+
+    double t2 = now_seconds();
+    BitMatrix* closure = bitmatrix_transitive_closure(bm);
+    double t3 = now_seconds();
+
+    size_t int_matrix = (size_t)V * V * sizeof(int) + V * sizeof(int*);
+    printf("Vertices: %d, edges: %lld\n", V, bm->num_edges);
+    printf("int matrix:    %zu bytes\n", int_matrix);
+    printf("bitset matrix: %zu bytes (%.1fx smaller)\n",
+           bitmatrix_memory_bytes(bm), (double)int_matrix / bitmatrix_memory_bytes(bm));
+    printf("For V = 50,000: %.1f GB → %.0f MB\n",
+           50000.0 * 50000.0 * 4 / 1e9, 50000.0 * 50000.0 / 8 / 1e6);
+    printf("\nBFS: %d reached in %.4f s (%d mismatches vs compressed BFS)\n",
+           reached, t1 - t0, mismatches);
+    printf("Transitive closure: %.3f s (%lld reachable pairs)\n",
+           t3 - t2, closure->num_edges);
+
+    free(d_bits);
+    free(d_ref);
+    bitmatrix_destroy(closure);
+    cgraph_destroy(cg);
+    bitmatrix_destroy(bm);
+}
+
+void test_arena_graph() {
+    printf("\n=== Test 18: Arena-backed Adjacency List ===\n\n");
+
+    int V = 200000;
+    int E = 1000000;
+    int rounds = 3;
+
+    // Same random edge stream for both allocators
+    Edge* edges = (Edge*)malloc(E * sizeof(Edge));
+    srand(42);
+    for (int i = 0; i < E; i++) {
+        edges[i].u = rand() % V;
+        edges[i].v = rand() % V;
+        edges[i].weight = rand() % 20 + 1;
+    }
+
+    printf("Build + destroy %d rounds of V=%d, E=%d (undirected, weighted)\n\n",
+           rounds, V, E);
+
+    // malloc per node
+    double build_malloc = 0.0, destroy_malloc = 0.0;
+    for (int r = 0; r < rounds; r++) {
+        double t0 = now_seconds();
+        Graph* graph = graph_create(V, UNDIRECTED, WEIGHTED, ADJACENCY_LIST);
+        for (int i = 0; i < E; i++) {
+            graph_add_edge(graph, edges[i].u, edges[i].v, edges[i].weight);
+        }
+        double t1 = now_seconds();
+        graph_destroy(graph);
+        double t2 = now_seconds();
+        build_malloc += t1 - t0;
+        destroy_malloc += t2 - t1;
+    }
+
+    // Arena
+    double build_arena = 0.0, destroy_arena = 0.0;
+    int slabs = 0;
+    for (int r = 0; r < rounds; r++) {
+        double t0 = now_seconds();
+        Graph* graph = graph_create_arena(V, UNDIRECTED, WEIGHTED, E);
+        for (int i = 0; i < E; i++) {
+            graph_add_edge(graph, edges[i].u, edges[i].v, edges[i].weight);
+        }
+        double t1 = now_seconds();
+        slabs = graph->arena->num_slabs;
+        graph_destroy(graph);
+        double t2 = now_seconds();
+        build_arena += t1 - t0;
+        destroy_arena += t2 - t1;
+    }
+
+    // Arena reused across rounds via graph_clear()
+    double build_reuse = 0.0;
+    Graph* reused = graph_create_arena(V, UNDIRECTED, WEIGHTED, E);
+    for (int r = 0; r < rounds; r++) {
+        double t0 = now_seconds();
+        graph_clear(reused);
+        for (int i = 0; i < E; i++) {
+            graph_add_edge(reused, edges[i].u, edges[i].v, edges[i].weight);
+        }
+        build_reuse += now_seconds() - t0;
+    }
+
+    printf("Allocator        | Build (avg) | Destroy (avg)\n");
+    printf("-----------------|-------------|--------------\n");
+    printf("malloc per node  | %8.4f s  | %8.4f s\n",
+           build_malloc / rounds, destroy_malloc / rounds);
+    printf("arena            | %8.4f s  | %8.4f s  (%d slabs)\n",
+           build_arena / rounds, destroy_arena / rounds, slabs);
+    printf("arena + clear    | %8.4f s  |     (reused)\n", build_reuse / rounds);
+
+    printf("\nSanity check: %d edges in reused graph, has_edge(%d,%d) = %s\n",
+           reused->num_edges, edges[0].u, edges[0].v,
+           graph_has_edge(reused, edges[0].u, edges[0].v) ? "yes" : "no");
+
+    graph_destroy(reused);
+    free(edges);
+}
+
+void test_edge_index() {
+    printf("\n=== Test 19: Hashed Edge Index (O(1) has_edge) ===\n\n");
+
+    // Hub-heavy ingest with duplicates: every edge touches vertex 0
+    int V = 50000;
+    int E = 40000;
+    int* targets = (int*)malloc(E * sizeof(int));
+    srand(42);
+    for (int i = 0; i < E; i++) {
+        targets[i] = 1 + rand() % (V - 1);  // Duplicates are likely
+    }
+
+    printf("Ingest %d hub edges 0→v with dedup-on-insert (V=%d)\n\n", E, V);
+
+    Graph* plain = graph_create(V, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+    double t0 = now_seconds();
+    for (int i = 0; i < E; i++) {
+        graph_add_edge(plain, 0, targets[i], i % 20 + 1);
+    }
+    double t1 = now_seconds();
+
+    Graph* indexed = graph_create(V, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+    graph_enable_edge_index(indexed);
+    double t2 = now_seconds();
+    for (int i = 0; i < E; i++) {
+        graph_add_edge(indexed, 0, targets[i], i % 20 + 1);
+    }
+    double t3 = now_seconds();
+
+    printf("List scan:   %.4f s (%d distinct edges)\n", t1 - t0, plain->num_edges);
+    printf("Edge index:  %.4f s (%d distinct edges)\n", t3 - t2, indexed->num_edges);
+    printf("Speedup:     %.1fx\n", (t1 - t0) / (t3 - t2 > 0 ? t3 - t2 : 1e-9));
+
+    // Lookups must agree, including weights and absent edges
+    int mismatches = 0;
+    for (int v = 0; v < V; v++) {
+        if (graph_has_edge(plain, 0, v) != graph_has_edge(indexed, 0, v) ||
+            get_edge_weight(plain, 0, v) != get_edge_weight(indexed, 0, v)) {
+            mismatches++;
+        }
+    }
+    printf("\nLookup agreement over all %d targets: %d mismatches\n", V, mismatches);
+    printf("Index: %zu entries in %zu slots (load %.2f)\n",
+           indexed->edge_index->count, indexed->edge_index->capacity,
+           (double)indexed->edge_index->count / indexed->edge_index->capacity);
+
+    graph_destroy(plain);
+    graph_destroy(indexed);
+    free(targets);
+}
+
+void test_dynamic_sssp() {
+    printf("\n=== Test 20: Dynamic Graph with Incremental Shortest Paths ===\n\n");
+
+    int V = 100000;
+    int E = 400000;
+    int batches = 50;
+    int batch_size = 200;
+
+    srand(42);
+    DynamicGraph* dg = dyn_graph_create(V, DIRECTED);
+    EdgeUpdate* updates = (EdgeUpdate*)malloc(E * sizeof(EdgeUpdate));
+    for (int i = 0; i < E; i++) {
+        updates[i].src = rand() % V;
+        updates[i].dest = rand() % V;
+        updates[i].weight = rand() % 100 + 1;
+    }
+    dyn_graph_apply_batch(dg, updates, E, updates);
+    printf("Graph: V=%d, E=%d (directed, weights 1-100)\n", V, dg->num_edges);
+
+    double t0 = now_seconds();
+    SSSPState* st = sssp_create(dg, 0);
+    double full_time = now_seconds() - t0;
+    printf("Initial Dijkstra from 0: %.4f s\n\n", full_time);
+
+    // Stream of batches: half new edges, half decreases of existing edges
+    double repair_time = 0.0;
+    double recompute_time = 0.0;
+    long long affected = 0;
+    int applied = 0;
+    int mismatches = 0;
+
+    for (int b = 0; b < batches; b++) {
+        for (int i = 0; i < batch_size; i++) {
+            EdgeUpdate* u = &updates[i];
+            u->src = rand() % V;
+            if (i % 2 == 0 || dg->adj[u->src].size == 0) {
+                u->dest = rand() % V;
+                u->weight = rand() % 100 + 1;
+            } else {
+                int k = rand() % dg->adj[u->src].size;
+                u->dest = dg->adj[u->src].dest[k];
+                u->weight = dg->adj[u->src].weight[k] / 2;
+            }
+        }
+
+        t0 = now_seconds();
+        int m = dyn_graph_apply_batch(dg, updates, batch_size, updates);
+        affected += sssp_repair(st, dg, updates, m);
+        repair_time += now_seconds() - t0;
+        applied += m;
+
+        t0 = now_seconds();
+        SSSPState* fresh = sssp_create(dg, 0);
+        recompute_time += now_seconds() - t0;
+
+        for (int v = 0; v < V; v++) {
+            if (fresh->distance[v] != st->distance[v]) mismatches++;
+        }
+        sssp_destroy(fresh);
+    }
+
+    printf("%d batches × %d updates (%d effective)\n", batches, batch_size, applied);
+    printf("Incremental repair:  %.4f s total, %.1f improvements/batch\n",
+           repair_time, (double)affected / batches);
+    printf("Full recomputation:  %.4f s total\n", recompute_time);
+    printf("Speedup:             %.1fx\n",
+           recompute_time / (repair_time > 0 ? repair_time : 1e-9));
+    printf("Distance mismatches vs recomputation: %d\n", mismatches);
+
+    // Small undirected example that shows the repair step by step
+    printf("\nUndirected example: path 0-1-2-3 (weight 5 each), then add 0-3 (w=4)\n");
+    DynamicGraph* small = dyn_graph_create(4, UNDIRECTED);
+    EdgeUpdate path[] = {{0, 1, 5}, {1, 2, 5}, {2, 3, 5}};
+    dyn_graph_apply_batch(small, path, 3, path);
+    SSSPState* s = sssp_create(small, 0);
+    printf("Before: ");
+    for (int v = 0; v < 4; v++) printf("d[%d]=%d ", v, s->distance[v]);
+
+    EdgeUpdate shortcut[] = {{0, 3, 4}, {1, 2, 9}};  // Second is an increase → ignored
+    int m = dyn_graph_apply_batch(small, shortcut, 2, shortcut);
+    int changed = sssp_repair(s, small, shortcut, m);
+    printf("\nAfter:  ");
+    for (int v = 0; v < 4; v++) printf("d[%d]=%d ", v, s->distance[v]);
+    printf("\n(%d of 2 updates applied, %d distances improved)\n", m, changed);
+
+    sssp_destroy(s);
+    dyn_graph_destroy(small);
+    sssp_destroy(st);
+    dyn_graph_destroy(dg);
+    free(updates);
+}
+
+void test_typed_graphs() {
+    printf("\n=== Test 21: Typed Graphs (compile-time ID/weight widths) ===\n\n");
+
+    // 1. Compact 16-bit weights on a typical sparse graph
+    int V = 100000;
+    srand(42);
+    Graph* graph = graph_create(V, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+    for (int i = 0; i < 5 * V; i++) {
+        graph_add_edge(graph, rand() % V, rand() % V, rand() % 100 + 1);
+    }
+
+    TypedGraph_u32w16* g16 = tgraph_u32w16_from_graph(graph);
+    TypedGraph_u32w32* g32 = tgraph_u32w32_from_graph(graph);
+    size_t list_bytes = (size_t)graph->num_edges * sizeof(AdjListNode) + V * sizeof(AdjListNode*);
+
+    printf("Sparse graph: V=%d, E=%d\n", V, graph->num_edges);
+    printf("  Adjacency list (int):   %8.2f MB\n", list_bytes / 1e6);
+    printf("  CSR u32 IDs / i32 wts:  %8.2f MB\n", tgraph_u32w32_memory_bytes(g32) / 1e6);
+    printf("  CSR u32 IDs / i16 wts:  %8.2f MB\n", tgraph_u32w16_memory_bytes(g16) / 1e6);
+
+    int32_t* d16 = (int32_t*)malloc(V * sizeof(int32_t));
+    int64_t* d32 = (int64_t*)malloc(V * sizeof(int64_t));
+    double t0 = now_seconds();
+    tgraph_u32w16_dijkstra(g16, 0, d16);
+    double t1 = now_seconds();
+    tgraph_u32w32_dijkstra(g32, 0, d32);
+    double t2 = now_seconds();
+
+    int mismatches = 0;
+    for (int v = 0; v < V; v++) {
+        bool inf16 = d16[v] == INT32_MAX;
+        bool inf32 = d32[v] == INT64_MAX;
+        if (inf16 != inf32 || (!inf16 && d16[v] != d32[v])) mismatches++;
+    }
+    printf("\nDijkstra from 0: i16 %.4f s, i32 %.4f s, %d mismatches\n",
+           t1 - t0, t2 - t1, mismatches);
+
+    // 2. Weights that don't fit are rejected, not truncated
+    Graph* heavy = graph_create(3, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+    graph_add_edge(heavy, 0, 1, 40000);
+    TypedGraph_u32w16* rejected = tgraph_u32w16_from_graph(heavy);
+    printf("\nWeight 40000 into int16 graph: %s\n", rejected == NULL ? "rejected (NULL)" : "accepted");
+    graph_destroy(heavy);
+
+    // 3. Path sums beyond INT_MAX: int wraps, int64 distances don't
+    printf("\nChain 0→1→...→5 with weight 1,000,000,000 per edge:\n");
+    uint32_t src[5], dst[5];
+    int32_t w32[5];
+    for (int i = 0; i < 5; i++) {
+        src[i] = i;
+        dst[i] = i + 1;
+        w32[i] = 1000000000;
+    }
+    TypedGraph_u32w32* chain = tgraph_u32w32_from_arcs(6, src, dst, w32, 5, DIRECTED);
+    int64_t cd[6];
+    tgraph_u32w32_dijkstra(chain, 0, cd);
+    int wrapped = (int)(unsigned)(3u * 1000000000u);
+    printf("  int sum to vertex 3:    %d (wrapped)\n", wrapped);
+    printf("  int64 distance to 5:    %lld\n", (long long)cd[5]);
+
+    // Saturation: i16 weights with i32 distances clamp at INF, never wrap
+    printf("  i32 relax_sum(INT32_MAX - 5, 100) = %s\n",
+           tgraph_u32w16_relax_sum(INT32_MAX - 5, 100) == INT32_MAX ? "INF (saturated)" : "wrapped!");
+
+    // 4. 64-bit IDs and float weights use the same generated code
+    uint64_t s64[2] = {0, 1}, t64[2] = {1, 2};
+    int64_t w64[2] = {INT64_MAX / 2, INT64_MAX / 2 + 10};
+    TypedGraph_u64w64* big = tgraph_u64w64_from_arcs(3, s64, t64, w64, 2, DIRECTED);
+    int64_t bd[3];
+    tgraph_u64w64_dijkstra(big, 0, bd);
+    printf("\nu64/i64: d[1]=%lld, d[2]=%s\n", (long long)bd[1],
+           bd[2] == INT64_MAX ? "INF (sum overflowed int64, saturated)" : "finite");
+
+    uint32_t sf[3] = {0, 1, 0}, tf[3] = {1, 2, 2};
+    float wf[3] = {0.25f, 0.5f, 1.0f};
+    TypedGraph_u32f32* fg = tgraph_u32f32_from_arcs(3, sf, tf, wf, 3, UNDIRECTED);
+    double fd[3];
+    tgraph_u32f32_dijkstra(fg, 0, fd);
+    printf("u32/float (undirected): d[1]=%.2f, d[2]=%.2f\n", fd[1], fd[2]);
+
+    // An arc to a vertex that does not exist is rejected, not written past offsets
+    tf[2] = 3;
+    TypedGraph_u32f32* bad = tgraph_u32f32_from_arcs(3, sf, tf, wf, 3, UNDIRECTED);
+    printf("Arc 0 → 3 in a 3-vertex graph: %s\n", bad == NULL ? "rejected" : "ACCEPTED");
+    if (bad) tgraph_u32f32_destroy(bad);
+
+    tgraph_u32f32_destroy(fg);
+    tgraph_u64w64_destroy(big);
+    tgraph_u32w32_destroy(chain);
+    tgraph_u32w16_destroy(g16);
+    tgraph_u32w32_destroy(g32);
+    free(d16);
+    free(d32);
+    graph_destroy(graph);
+}
+
+typedef struct {
+    Graph* graph;
+    GraphPartition* part;
+    int source;
+    int* bfs;                    // Filled on rank 0
+    int* sssp;
+    int bfs_levels;
+    int sssp_rounds;
+    long long bytes;
+} DistributedDemo;
+
+static int distributed_demo_main(Transport* t, void* arg) {
+    DistributedDemo* demo = (DistributedDemo*)arg;
+    LocalGraph* lg = local_graph_extract(demo->graph, demo->part, t->rank);
+
+    int levels = dist_bfs(t, demo->part, lg, demo->source, demo->bfs);
+    int rounds = levels < 0 ? -1 : dist_sssp(t, demo->part, lg, demo->source, demo->sssp);
+    long long bytes = 0;
+    int status = rounds < 0 ? -1 : dist_allreduce_sum(t, t->bytes_sent, &bytes);
+
+    if (t->rank == 0) {
+        demo->bfs_levels = levels;
+        demo->sssp_rounds = rounds;
+        demo->bytes = bytes;
+    }
+    local_graph_destroy(lg);
+    return status;
+}
+
+void test_distributed_graph() {
+    printf("\n=== Test 22: Partitioned Graph, Distributed BFS/SSSP ===\n\n");
+
+    int V = 20000;
+    int P = 4;
+    srand(42);
+    Graph* graph = graph_create(V, UNDIRECTED, WEIGHTED, ADJACENCY_LIST);
+    graph_enable_edge_index(graph);
+    for (int i = 0; i < 4 * V; i++) {
+        // Mostly-local edges with some long-range ones, like real graphs
+        int u = rand() % V;
+        int v = rand() % 10 == 0 ? rand() % V : (u + 1 + rand() % 50) % V;
+        graph_add_edge(graph, u, v, rand() % 20 + 1);
+    }
+
+    GraphPartition* part = graph_partition_1d(graph, P);
+    graph_partition_print(part);
+
+    DistributedDemo demo = {graph, part, 0, NULL, NULL, 0, 0, 0};
+    demo.bfs = (int*)malloc(V * sizeof(int));
+    demo.sssp = (int*)malloc(V * sizeof(int));
+
+    printf("\nRunning on %d processes (Unix-domain socket mesh)...\n", P);
+    double t0 = now_seconds();
+    int status = dist_run_local(P, distributed_demo_main, &demo);
+    double elapsed = now_seconds() - t0;
+    printf("Status: %s, %.4f s, %.2f MB exchanged\n",
+           status == 0 ? "ok" : "FAILED", elapsed, demo.bytes / 1e6);
+    printf("BFS: %d levels   SSSP: %d rounds\n", demo.bfs_levels, demo.sssp_rounds);
+
+    // Check against single-process results
+    CompressedGraph* cg = cgraph_from_graph(graph);
+    int* ref = (int*)malloc(V * sizeof(int));
+    int bfs_mismatch = 0, sssp_mismatch = 0;
+    cgraph_bfs(cg, 0, ref);
+    for (int v = 0; v < V; v++) if (ref[v] != demo.bfs[v]) bfs_mismatch++;
+    cgraph_dijkstra(cg, 0, ref);
+    for (int v = 0; v < V; v++) if (ref[v] != demo.sssp[v]) sssp_mismatch++;
+    printf("Mismatches vs single process: BFS %d, SSSP %d\n", bfs_mismatch, sssp_mismatch);
+
+    printf("\nSample distances from 0: ");
+    for (int v = 1; v <= 5; v++) printf("d[%d]=%d ", v, demo.sssp[v]);
+    printf("\n");
+
+    free(ref);
+    cgraph_destroy(cg);
+    free(demo.bfs);
+    free(demo.sssp);
+    graph_partition_destroy(part);
+    graph_destroy(graph);
+}
+
+void test_query_engine() {
+    printf("\n=== Test 23: Batched Shortest-Path Query Engine ===\n\n");
+
+    int V = 500000;
+    int num_queries = 20000;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 2) threads = 2;
+    if (threads > 8) threads = 8;
+
+    srand(42);
+    Graph* graph = graph_create(V, UNDIRECTED, WEIGHTED, ADJACENCY_LIST);
+    graph_enable_edge_index(graph);
+    for (int i = 0; i < 3 * V; i++) {
+        int u = rand() % V;
+        int v = (u + 1 + rand() % 100) % V;  // Local edges → short queries
+        graph_add_edge(graph, u, v, rand() % 20 + 1);
+    }
+
+    // Short queries: dst is a few hops from src
+    PathQuery* queries = (PathQuery*)malloc(num_queries * sizeof(PathQuery));
+    for (int i = 0; i < num_queries; i++) {
+        int src = rand() % V;
+        int v = src;
+        for (int step = 0; step < 4; step++) {
+            AdjListNode* n = graph->adj_list[v];
+            int skip = rand() % 4;
+            while (n && n->next && skip-- > 0) n = n->next;
+            if (n) v = n->dest;
+        }
+        queries[i].src = src;
+        queries[i].dst = v;
+    }
+    printf("Graph: V=%d, E=%d   %d short (src,dst) queries\n\n", V, graph->num_edges, num_queries);
+
+    // Baseline: per-query O(V) allocation + initialization (like graph_dijkstra)
+    CompressedGraph* cg = cgraph_from_graph(graph);
+    int baseline_n = 10;
+    int* ref = (int*)malloc(V * sizeof(int));
+    double t0 = now_seconds();
+    for (int i = 0; i < baseline_n; i++) {
+        int* dist = (int*)malloc(V * sizeof(int));
+        cgraph_dijkstra(cg, queries[i].src, dist);
+        if (i == 0) memcpy(ref, dist, V * sizeof(int));
+        free(dist);
+    }
+    double per_query_baseline = (now_seconds() - t0) / baseline_n;
+
+    QueryEngine* e1 = query_engine_create(graph, 1);
+    t0 = now_seconds();
+    query_engine_run(e1, queries, num_queries, QUERY_DIJKSTRA);
+    double engine1 = now_seconds() - t0;
+
+    QueryEngine* en = query_engine_create(graph, threads);
+    PathQuery* copy = (PathQuery*)malloc(num_queries * sizeof(PathQuery));
+    memcpy(copy, queries, num_queries * sizeof(PathQuery));
+    t0 = now_seconds();
+    query_engine_run(en, copy, num_queries, QUERY_DIJKSTRA);
+    double engine_n = now_seconds() - t0;
+
+    int mismatches = 0;
+    for (int i = 0; i < num_queries; i++) {
+        if (copy[i].distance != queries[i].distance) mismatches++;
+    }
+    if (queries[0].distance != ref[queries[0].dst]) mismatches++;
+
+    printf("Dijkstra, full O(V) per query:  %10.1f µs/query\n", per_query_baseline * 1e6);
+    printf("Engine, 1 thread:               %10.1f µs/query\n", engine1 / num_queries * 1e6);
+    printf("Engine, %d threads:              %10.1f µs/query (%.0f queries/s)\n",
+           threads, engine_n / num_queries * 1e6, num_queries / engine_n);
+    printf("Avg vertices touched per query: %10.1f (of %d)\n",
+           (double)query_engine_touched(e1) / num_queries, V);
+    printf("Mismatches (1 vs %d threads, and vs full Dijkstra): %d\n", threads, mismatches);
+
+    // Reusing the pool: a BFS batch on the same engine
+    t0 = now_seconds();
+    query_engine_run(en, copy, num_queries, QUERY_BFS);
+    printf("\nBFS batch on the same pool:     %10.1f µs/query\n",
+           (now_seconds() - t0) / num_queries * 1e6);
+    printf("Sample: %d → %d  weighted=%d (%d hops), bfs hops=%d\n",
+           queries[0].src, queries[0].dst, queries[0].distance, queries[0].hops, copy[0].distance);
+
+    query_engine_destroy(e1);
+    query_engine_destroy(en);
+    cgraph_destroy(cg);
+    free(ref);
+    free(copy);
+    free(queries);
+    graph_destroy(graph);
+}
+
+void test_parallel_bipartite() {
+    printf("\n=== Test 24: Parallel Bipartiteness (union-find parity) ===\n\n");
+
+    int V = 400000;
+    int E = 2000000;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 2) threads = 2;
+    if (threads > 8) threads = 8;
+
+    // Random bipartite graph: even vertices on one side, odd on the other
+    srand(42);
+    Graph* graph = graph_create(V, UNDIRECTED, UNWEIGHTED, ADJACENCY_LIST);
+    for (int i = 0; i < E; i++) {
+        int u = 2 * (rand() % (V / 2));
+        int v = 2 * (rand() % (V / 2)) + 1;
+        graph_add_edge(graph, u, v, 1);
+    }
+    printf("Graph: V=%d, E=%d (sides: even / odd vertices)\n\n", V, graph->num_edges);
+
+    int* serial_set = (int*)malloc(V * sizeof(int));
+    int* parallel_set = (int*)malloc(V * sizeof(int));
+    int serial_sizes[2], parallel_sizes[2], conflict[2];
+
+    double t0 = now_seconds();
+    bool serial = is_bipartite_with_sets(graph, serial_set, serial_sizes);
+    double t1 = now_seconds();
+    bool parallel = graph_is_bipartite_parallel(graph, threads, parallel_set, parallel_sizes, conflict);
+    double t2 = now_seconds();
+
+    int mismatches = 0;
+    for (int v = 0; v < V; v++) if (serial_set[v] != parallel_set[v]) mismatches++;
+
+    printf("Serial BFS coloring:    %s  sets %d / %d  %.4f s\n",
+           serial ? "bipartite" : "NOT bipartite", serial_sizes[0], serial_sizes[1], t1 - t0);
+    printf("Parallel (%d threads):   %s  sets %d / %d  %.4f s\n", threads,
+           parallel ? "bipartite" : "NOT bipartite", parallel_sizes[0], parallel_sizes[1], t2 - t1);
+    printf("Set assignment mismatches: %d\n", mismatches);
+
+    // An edge inside one side closes an odd cycle
+    int a = 0, b = 0;
+    for (AdjListNode* n = graph->adj_list[1]; n != NULL && b == 0; n = n->next) {
+        if (a == 0) a = n->dest;
+        else if (n->dest != a) b = n->dest;
+    }
+    graph_add_edge(graph, a, b, 1);
+    printf("\nAdd edge %d-%d (both even, both adjacent to 1 → triangle)\n", a, b);
+    parallel = graph_is_bipartite_parallel(graph, threads, parallel_set, parallel_sizes, conflict);
+    printf("Parallel: %s, conflicting edge %d-%d\n",
+           parallel ? "bipartite" : "NOT bipartite", conflict[0], conflict[1]);
+
+    free(serial_set);
+    free(parallel_set);
+    graph_destroy(graph);
+}
+
+static long file_size(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+// Byte-for-byte comparison of two files (false if either is unreadable)
+static bool files_equal(const char* path_a, const char* path_b) {
+    FILE* a = fopen(path_a, "rb");
+    FILE* b = fopen(path_b, "rb");
+    bool equal = a != NULL && b != NULL;
+    char buf_a[65536], buf_b[65536];
+    while (equal) {
+        size_t n_a = fread(buf_a, 1, sizeof(buf_a), a);
+        size_t n_b = fread(buf_b, 1, sizeof(buf_b), b);
+        if (n_a != n_b || memcmp(buf_a, buf_b, n_a) != 0) equal = false;
+        if (n_a < sizeof(buf_a)) break;
+    }
+    if (equal && (ferror(a) || ferror(b))) equal = false;
+    if (a) fclose(a);
+    if (b) fclose(b);
+    return equal;
+}
+
+void test_streaming_export() {
+    printf("\n=== Test 25: Streaming Export (DOT / GraphML / binary) ===\n\n");
+
+    int V = 300000;
+    int E = 2000000;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 2) threads = 2;
+    if (threads > 8) threads = 8;
+
+    srand(42);
+    Graph* graph = graph_create(V, DIRECTED, WEIGHTED, ADJACENCY_LIST);
+    for (int i = 0; i < E; i++) {
+        graph_add_edge(graph, rand() % V, rand() % V, rand() % 100 + 1);
+    }
+    printf("Graph: V=%d, E=%d\n", V, graph->num_edges);
+
+    // Baseline: fprintf per edge (silence its usage hints)
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    FILE* devnull = fopen("/dev/null", "w");
+    dup2(fileno(devnull), STDOUT_FILENO);
+    double t0 = now_seconds();
+    graph_export_dot(graph, "out/export_baseline.dot");
+    fflush(stdout);
+    double baseline = now_seconds() - t0;
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    fclose(devnull);
+
+    ExportOptions opts = {EXPORT_DOT, 1, 0, 1.0, 7};
+    t0 = now_seconds();
+    long long n1 = graph_export(graph, "out/export_1t.dot", &opts);
+    double one = now_seconds() - t0;
+
+    opts.num_threads = threads;
+    t0 = now_seconds();
+    long long nt = graph_export(graph, "out/export_nt.dot", &opts);
+    double many = now_seconds() - t0;
+
+    printf("\nDOT export:\n");
+    printf("  graph_export_dot (fprintf):  %.3f s  %ld bytes\n", baseline, file_size("out/export_baseline.dot"));
+    printf("  graph_export, 1 thread:      %.3f s  %ld bytes, %lld edges\n", one, file_size("out/export_1t.dot"), n1);
+    printf("  graph_export, %d threads:     %.3f s  %ld bytes, %lld edges\n", threads, many, file_size("out/export_nt.dot"), nt);
+    bool same = files_equal("out/export_baseline.dot", "out/export_nt.dot");
+    printf("  Output identical to graph_export_dot: %s\n", same ? "yes" : "NO");
+
+    opts.format = EXPORT_GRAPHML;
+    t0 = now_seconds();
+    long long ng = graph_export(graph, "out/export.graphml", &opts);
+    printf("\nGraphML:      %.3f s  %ld bytes, %lld edges\n", now_seconds() - t0, file_size("out/export.graphml"), ng);
+
+    opts.format = EXPORT_BINARY_EDGE_LIST;
+    t0 = now_seconds();
+    long long nb = graph_export(graph, "out/export.edges", &opts);
+    printf("Binary edges: %.3f s  %ld bytes, %lld edges (24-byte header + 12 B/edge)\n",
+           now_seconds() - t0, file_size("out/export.edges"), nb);
+
+    // Limiting output for debugging snapshots
+    opts.format = EXPORT_DOT;
+    opts.max_edges = 1000;
+    long long limited = graph_export(graph, "out/export_first1000.dot", &opts);
+    opts.max_edges = 0;
+    opts.sample_rate = 0.01;
+    long long s1 = graph_export(graph, "out/export_sample_a.dot", &opts);
+    opts.num_threads = 1;
+    long long s2 = graph_export(graph, "out/export_sample_b.dot", &opts);
+    bool sample_same = files_equal("out/export_sample_a.dot", "out/export_sample_b.dot");
+
+    printf("\nmax_edges=1000:     %lld edges, %ld bytes\n", limited, file_size("out/export_first1000.dot"));
+    printf("sample_rate=0.01:   %lld edges (%d threads) / %lld edges (1 thread), identical: %s\n",
+           s1, threads, s2, sample_same ? "yes" : "NO");
+
+    remove("out/export_baseline.dot");
+    remove("out/export_1t.dot");
+    remove("out/export_nt.dot");
+    remove("out/export.graphml");
+    remove("out/export.edges");
+    remove("out/export_first1000.dot");
+    remove("out/export_sample_a.dot");
+    remove("out/export_sample_b.dot");
+    graph_destroy(graph);
+}
+
 // ============================================================
 // MAIN
 // ============================================================
 
+#ifndef SKIP_MAIN
 int main() {
     char choice;
 
@@ -2744,6 +7127,17 @@ int main() {
         printf("\nAdvanced Graph Algorithms:\n");
         printf("d. Topological Sort (Kahn's Algorithm)\n");
         printf("e. Floyd-Warshall (All-Pairs Shortest Paths)\n");
+        printf("f. Betweenness Centrality (Brandes, multi-threaded)\n");
+        printf("g. Compressed Graph (BFS/Dijkstra/PageRank on varint adjacency)\n");
+        printf("h. Bitset Matrix (popcount intersection, word-parallel BFS, closure)\n");
+        printf("i. Arena Allocator (slab-backed adjacency lists)\n");
+        printf("j. Edge Index (O(1) has_edge, dedup-on-insert)\n");
+        printf("k. Dynamic Graph (batched updates, incremental SSSP)\n");
+        printf("l. Typed Graphs (16/32/64-bit IDs and weights, saturating relax)\n");
+        printf("m. Distributed BFS/SSSP (1D partition, multi-process sockets)\n");
+        printf("n. Query Engine (batched src→dst queries, thread pool, reused scratch)\n");
+        printf("o. Parallel Bipartiteness (union-find parity two-coloring)\n");
+        printf("p. Streaming Export (buffered multi-threaded DOT/GraphML/binary)\n");
         printf("\nx. Exit\n");
         printf("Enter choice: ");
         scanf(" %c", &choice);
@@ -2782,6 +7176,28 @@ int main() {
             test_topological_sort();
         } else if (choice == 'e') {
             test_floyd_warshall();
+        } else if (choice == 'f') {
+            test_betweenness_centrality();
+        } else if (choice == 'g') {
+            test_compressed_graph();
+        } else if (choice == 'h') {
+            test_bitset_matrix();
+        } else if (choice == 'i') {
+            test_arena_graph();
+        } else if (choice == 'j') {
+            test_edge_index();
+        } else if (choice == 'k') {
+            test_dynamic_sssp();
+        } else if (choice == 'l') {
+            test_typed_graphs();
+        } else if (choice == 'm') {
+            test_distributed_graph();
+        } else if (choice == 'n') {
+            test_query_engine();
+        } else if (choice == 'o') {
+            test_parallel_bipartite();
+        } else if (choice == 'p') {
+            test_streaming_export();
         } else {
             printf("Invalid choice\n");
         }
@@ -2789,3 +7205,4 @@ int main() {
 
     return 0;
 }
+#endif  // SKIP_MAIN
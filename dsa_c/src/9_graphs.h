@@ -0,0 +1,154 @@
+#ifndef GRAPHS_H
+#define GRAPHS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+
+// ============================================================
+// ENUMS AND CONSTANTS
+// ============================================================
+
+typedef enum {
+    DIRECTED,
+    UNDIRECTED
+} GraphType;
+
+typedef enum {
+    WEIGHTED,
+    UNWEIGHTED
+} WeightType;
+
+typedef enum {
+    ADJACENCY_MATRIX,
+    ADJACENCY_LIST
+} RepType;
+
+#define INF INT_MAX
+#define NO_EDGE 0
+
+// ============================================================
+// DATA STRUCTURES
+// ============================================================
+
+/**
+ * Node in adjacency list
+ */
+typedef struct AdjListNode {
+    int dest;                    // Destination vertex
+    int weight;                  // Edge weight (1 if unweighted)
+    struct AdjListNode* next;    // Next node in list
+} AdjListNode;
+
+/**
+ * Slab of adjacency list nodes (one large allocation)
+ */
+typedef struct NodeSlab {
+    struct NodeSlab* next;       // Next slab in allocation order
+    size_t used;                 // Nodes handed out from this slab
+    size_t capacity;             // Total nodes in this slab
+    AdjListNode nodes[];         // Node storage
+} NodeSlab;
+
+/**
+ * Arena allocator for adjacency list nodes
+ *
+ * Nodes are carved from large slabs in per-vertex chunks, so the
+ * neighbors of one vertex sit next to each other in memory.
+ */
+typedef struct {
+    NodeSlab* head;              // First slab
+    NodeSlab* current;           // Slab currently being carved
+    size_t slab_nodes;           // Capacity of newly allocated slabs
+    int num_slabs;
+
+    // Per-vertex chunk cursor
+    AdjListNode** chunk_next;    // Next free node in vertex's chunk
+    int* chunk_left;             // Free nodes left in vertex's chunk
+    int* chunk_size;             // Size of vertex's last chunk (grows 2x)
+} NodeArena;
+
+/**
+ * Open-addressed hash index keyed on (src, dst) → int
+ *
+ * Used to answer "does edge src→dst exist?" in O(1) expected time
+ * instead of walking src's adjacency list.
+ */
+typedef struct {
+    uint64_t* keys;              // Packed (src, dst) + 1; 0 marks an empty slot
+    int* values;                 // Payload (edge weight for Graph)
+    size_t capacity;             // Power of two
+    size_t count;
+} EdgeIndex;
+
+/**
+ * Graph structure supporting both representations
+ */
+typedef struct {
+    GraphType type;              // DIRECTED or UNDIRECTED
+    WeightType weight_type;      // WEIGHTED or UNWEIGHTED
+    RepType representation;      // ADJACENCY_MATRIX or ADJACENCY_LIST
+
+    int num_vertices;            // Number of vertices
+    int num_edges;               // Number of edges
+
+    // Adjacency Matrix (if representation == ADJACENCY_MATRIX)
+    int** adj_matrix;            // 2D array: adj_matrix[i][j] = weight of edge i->j
+
+    // Adjacency List (if representation == ADJACENCY_LIST)
+    AdjListNode** adj_list;      // Array of linked lists
+    NodeArena* arena;            // Slab allocator for list nodes (NULL = malloc per node)
+    EdgeIndex* edge_index;       // Optional O(1) edge lookup (NULL = scan lists)
+} Graph;
+
+/**
+ * Edge structure for MST algorithms and edge lists
+ */
+typedef struct {
+    int u, v;      // Edge endpoints
+    int weight;    // Edge weight
+} Edge;
+
+// Graph creation and management
+Graph* graph_create(int num_vertices, GraphType type, WeightType weight_type, RepType rep);
+Graph* graph_create_arena(int num_vertices, GraphType type, WeightType weight_type,
+                          int expected_edges);
+void graph_enable_edge_index(Graph* graph);
+void graph_clear(Graph* graph);
+void graph_destroy(Graph* graph);
+
+// Edge operations
+void graph_add_edge(Graph* graph, int src, int dest, int weight);
+bool graph_has_edge(Graph* graph, int src, int dest);
+int get_edge_weight(Graph* graph, int src, int dest);
+
+// Graph builders
+Graph* graph_create_complete(int num_vertices, GraphType type, WeightType weight_type);
+Graph* graph_create_sparse(int num_vertices, GraphType type, WeightType weight_type, int num_edges);
+Graph* graph_create_dag(int num_vertices, int num_edges, WeightType weight_type);
+Graph* graph_create_bipartite(int num_vertices, GraphType type, WeightType weight_type, int num_edges);
+
+// Shortest paths (print their results)
+void graph_bfs_shortest_path(Graph* graph, int src, int dest);
+void graph_dijkstra(Graph* graph, int src, int dest);
+void graph_bellman_ford(Graph* graph, int src, int dest);
+int** graph_floyd_warshall(Graph* graph);
+void floyd_warshall_free(int** dist, int V);
+
+// Minimum spanning tree (caller frees the returned edges)
+Edge* graph_prim_mst(Graph* graph, int* mst_size);
+Edge* graph_kruskal_mst(Graph* graph, int* mst_size);
+
+// Quiet cores the above wrap (no output; parent may be NULL), also benchmarked
+bool graph_bfs_quiet(Graph* graph, int src, int* distance, int* parent);
+bool graph_dijkstra_quiet(Graph* graph, int src, int* distance, int* parent);
+int graph_bellman_ford_quiet(Graph* graph, int src, int* distance, int* parent);
+int** graph_floyd_warshall_quiet(Graph* graph);
+Edge* graph_prim_mst_quiet(Graph* graph, int* mst_size);
+Edge* graph_kruskal_mst_quiet(Graph* graph, int* mst_size);
+
+// Timing
+double now_seconds();
+
+#endif
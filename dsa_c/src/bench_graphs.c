@@ -0,0 +1,348 @@
+/*
+ * Graph Algorithm Benchmarks
+ *
+ * Runs the shortest-path and MST algorithms from 9_graphs.c on fixed,
+ * reproducible inputs and emits the measurements as JSON, so runs can be
+ * diffed to catch regressions.
+ *
+ * Inputs: undirected weighted graphs generated from a fixed seed - a
+ * spanning path (guarantees connectivity) plus random extra edges. The
+ * SAME edges are loaded into every representation, so matrix and list
+ * timings are directly comparable.
+ *
+ * Measured per (algorithm, representation, size):
+ * - wall time (min and median over repeats)
+ * - edges/second (E / median time)
+ * - hardware counters via perf_event_open (cycles, instructions,
+ *   cache misses, branch misses), averaged over repeats; null when the
+ *   kernel or container does not allow them
+ *
+ * Peak RSS (getrusage) only ever grows over the process, so it is
+ * reported once for the whole run rather than per measurement.
+ *
+ * The demo versions of these algorithms print their results, and printf
+ * would dominate the timings. They are thin wrappers over *_quiet cores,
+ * so the benchmark calls the cores directly: the same code the demos
+ * run, without the output. Single-source searches run to every vertex.
+ *
+ * Usage: bench_graphs [--quick] [--repeats N] [--output results.json]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "9_graphs.h"
+
+// ============================================================
+// INPUTS
+// ============================================================
+
+typedef struct {
+    const char* name;
+    int num_vertices;
+    int num_edges;
+} BenchSize;
+
+static const BenchSize SIZES[] = {
+    {"tiny", 200, 1000},
+    {"small", 1000, 5000},
+    {"medium", 10000, 50000},
+    {"large", 100000, 500000},
+};
+
+#define NUM_SIZES (int)(sizeof(SIZES) / sizeof(SIZES[0]))
+#define QUICK_SIZES 2            // --quick stops after "small"
+#define MATRIX_MAX_VERTICES 2000 // V² ints beyond this is too much memory
+
+static uint64_t bench_rng_state;
+
+static uint64_t bench_rng() {
+    uint64_t z = (bench_rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Deterministic edge list: path 0-1-...-(V-1) plus random edges
+ */
+static Edge* bench_generate_edges(const BenchSize* size, int* count) {
+    int V = size->num_vertices;
+    Edge* edges = (Edge*)malloc(size->num_edges * sizeof(Edge));
+    bench_rng_state = 0x5EEDULL + (uint64_t)V;
+
+    int n = 0;
+    for (int i = 0; i + 1 < V && n < size->num_edges; i++) {
+        edges[n++] = (Edge){i, i + 1, (int)(bench_rng() % 100) + 1};
+    }
+    while (n < size->num_edges) {
+        int u = (int)(bench_rng() % V);
+        int v = (int)(bench_rng() % V);
+        if (u != v) edges[n++] = (Edge){u, v, (int)(bench_rng() % 100) + 1};
+    }
+
+    *count = n;
+    return edges;
+}
+
+static Graph* bench_build_graph(int V, const Edge* edges, int count, RepType rep) {
+    Graph* graph = graph_create(V, UNDIRECTED, WEIGHTED, rep);
+    if (rep == ADJACENCY_LIST) graph_enable_edge_index(graph);
+    for (int i = 0; i < count; i++) {
+        graph_add_edge(graph, edges[i].u, edges[i].v, edges[i].weight);
+    }
+    return graph;
+}
+
+// ============================================================
+// ALGORITHMS UNDER TEST
+// ============================================================
+
+static void run_bfs(Graph* g) {
+    int* distance = (int*)malloc(g->num_vertices * sizeof(int));
+    graph_bfs_quiet(g, 0, distance, NULL);
+    free(distance);
+}
+
+static void run_dijkstra(Graph* g) {
+    int* distance = (int*)malloc(g->num_vertices * sizeof(int));
+    graph_dijkstra_quiet(g, 0, distance, NULL);
+    free(distance);
+}
+
+static void run_bellman_ford(Graph* g) {
+    int* distance = (int*)malloc(g->num_vertices * sizeof(int));
+    graph_bellman_ford_quiet(g, 0, distance, NULL);
+    free(distance);
+}
+
+static void run_floyd_warshall(Graph* g) {
+    floyd_warshall_free(graph_floyd_warshall_quiet(g), g->num_vertices);
+}
+
+static void run_prim(Graph* g) {
+    int n;
+    free(graph_prim_mst_quiet(g, &n));
+}
+
+static void run_kruskal(Graph* g) {
+    int n;
+    free(graph_kruskal_mst_quiet(g, &n));
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(Graph* g);
+    double max_work;             // Skip sizes where the cost model exceeds this
+    int cost_model;              // 0: V+E  1: V·E  2: V³  3: V²
+} BenchAlgorithm;
+
+static const BenchAlgorithm ALGORITHMS[] = {
+    {"bfs", run_bfs, 1e12, 0},
+    {"dijkstra", run_dijkstra, 1e9, 3},
+    {"bellman_ford", run_bellman_ford, 1e9, 1},
+    {"floyd_warshall", run_floyd_warshall, 1e7, 2},
+    {"prim", run_prim, 1e8, 3},
+    {"kruskal", run_kruskal, 1e12, 0},
+};
+
+#define NUM_ALGORITHMS (int)(sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]))
+
+static double bench_work(const BenchAlgorithm* alg, double V, double E) {
+    switch (alg->cost_model) {
+        case 1: return V * E;
+        case 2: return V * V * V;
+        case 3: return V * V;
+        default: return V + E;
+    }
+}
+
+// ============================================================
+// MEASUREMENT
+// ============================================================
+
+#define NUM_COUNTERS 4
+
+static const char* COUNTER_NAMES[NUM_COUNTERS] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+static const uint64_t COUNTER_CONFIGS[NUM_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+typedef struct {
+    int fds[NUM_COUNTERS];       // -1 if unavailable
+    bool available;
+} PerfCounters;
+
+static void perf_counters_open(PerfCounters* pc) {
+    pc->available = true;
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = COUNTER_CONFIGS[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        pc->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pc->fds[i] < 0) pc->available = false;
+    }
+}
+
+static void perf_counters_close(PerfCounters* pc) {
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+    }
+}
+
+static void perf_counters_start(PerfCounters* pc) {
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static void perf_counters_stop(PerfCounters* pc, double* totals) {
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(pc->fds[i], &value, sizeof(value)) == sizeof(value)) {
+            totals[i] += (double)value;
+        }
+    }
+}
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;      // Kilobytes on Linux
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// ============================================================
+// MAIN
+// ============================================================
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    int repeats = 3;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+            if (repeats < 1) repeats = 1;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--quick] [--repeats N] [--output results.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* json = output ? fopen(output, "w") : stdout;
+    if (!json) {
+        fprintf(stderr, "Error: could not open output\n");
+        return 1;
+    }
+
+    PerfCounters pc;
+    perf_counters_open(&pc);
+    if (!pc.available) {
+        fprintf(stderr, "note: hardware counters unavailable (perf_event_open denied)\n");
+    }
+
+    fprintf(json, "{\n  \"benchmark\": \"graphs\",\n");
+    fprintf(json, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(json, "  \"repeats\": %d,\n", repeats);
+    fprintf(json, "  \"hardware_counters\": %s,\n", pc.available ? "true" : "false");
+    fprintf(json, "  \"results\": [");
+
+    double* times = (double*)malloc(repeats * sizeof(double));
+    bool first_result = true;
+    int num_sizes = quick ? QUICK_SIZES : NUM_SIZES;
+
+    for (int s = 0; s < num_sizes; s++) {
+        const BenchSize* size = &SIZES[s];
+        int count;
+        Edge* edges = bench_generate_edges(size, &count);
+
+        for (int r = 0; r < 2; r++) {
+            RepType rep = r == 0 ? ADJACENCY_LIST : ADJACENCY_MATRIX;
+            if (rep == ADJACENCY_MATRIX && size->num_vertices > MATRIX_MAX_VERTICES) continue;
+
+            Graph* graph = bench_build_graph(size->num_vertices, edges, count, rep);
+            const char* rep_name = rep == ADJACENCY_LIST ? "list" : "matrix";
+
+            for (int a = 0; a < NUM_ALGORITHMS; a++) {
+                const BenchAlgorithm* alg = &ALGORITHMS[a];
+                if (bench_work(alg, graph->num_vertices, graph->num_edges) > alg->max_work) continue;
+
+                fprintf(stderr, "%-15s %-6s %-6s V=%-7d E=%-7d ", alg->name, rep_name,
+                        size->name, graph->num_vertices, graph->num_edges);
+
+                double counters[NUM_COUNTERS] = {0};
+                for (int i = 0; i < repeats; i++) {
+                    perf_counters_start(&pc);
+                    double t0 = now_seconds();
+                    alg->run(graph);
+                    times[i] = now_seconds() - t0;
+                    perf_counters_stop(&pc, counters);
+                }
+                qsort(times, repeats, sizeof(double), compare_doubles);
+                double median = times[repeats / 2];
+                fprintf(stderr, "%.4f s\n", median);
+
+                fprintf(json, "%s\n    {\"algorithm\": \"%s\", \"representation\": \"%s\", "
+                        "\"size\": \"%s\", \"vertices\": %d, \"edges\": %d, "
+                        "\"wall_seconds_min\": %.6f, \"wall_seconds_median\": %.6f, "
+                        "\"edges_per_second\": %.0f",
+                        first_result ? "" : ",", alg->name, rep_name, size->name,
+                        graph->num_vertices, graph->num_edges, times[0], median,
+                        median > 0 ? graph->num_edges / median : 0.0);
+                for (int c = 0; c < NUM_COUNTERS; c++) {
+                    if (pc.fds[c] >= 0) {
+                        fprintf(json, ", \"%s\": %.0f", COUNTER_NAMES[c], counters[c] / repeats);
+                    } else {
+                        fprintf(json, ", \"%s\": null", COUNTER_NAMES[c]);
+                    }
+                }
+                fprintf(json, "}");
+                first_result = false;
+            }
+
+            graph_destroy(graph);
+        }
+        free(edges);
+    }
+
+    fprintf(json, "\n  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb());
+    if (json != stdout) fclose(json);
+
+    free(times);
+    perf_counters_close(&pc);
+    return 0;
+}